@@ -0,0 +1,177 @@
+#include "Corpus.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+namespace {
+
+    class Generator
+    {
+    public:
+        Generator(const Shape& shape, unsigned long long seed) : m_shape(shape), m_random(seed)
+        {
+            for (size_t i = 0; i < shape.args; ++i)
+                m_args.push_back({'x', static_cast<char>('a' + i / 26 % 26), static_cast<char>('a' + i % 26)});
+        }
+
+        std::string generate()
+        {
+            std::string infix;
+            node(infix, m_shape.depth);
+            return infix;
+        }
+
+        [[nodiscard]] const std::vector<std::string>& args() const
+        {
+            return m_args;
+        }
+
+    private:
+        void node(std::string& out, size_t depth)
+        {
+            for (size_t i = 0; i < m_shape.width; ++i)
+            {
+                if (i > 0)
+                {
+                    const char* op = binary();
+                    out += ' ';
+                    out += op;
+                    out += ' ';
+                    if (op[0] == '^')
+                    {
+                        out += pick({"2", "3", "4"});
+                        continue;
+                    }
+                }
+                operand(out, depth);
+            }
+        }
+
+        void operand(std::string& out, size_t depth)
+        {
+            const bool functions = m_shape.mix == OperatorMix::Functions;
+            if (functions && chance(0.3))
+            {
+                out += pick({"sin ", "exp ", "abs ", "-"});
+            }
+            if (depth > 1)
+            {
+                out += '(';
+                node(out, depth - 1);
+                out += ')';
+            }
+            else
+                leaf(out);
+            if (functions && chance(0.1))
+                out += '%';
+        }
+
+        void leaf(std::string& out)
+        {
+            if (m_args.empty() || chance(0.4))
+            {
+                std::uniform_real_distribution<double> number(0.5, 2.0);
+                char buffer[16];
+                std::snprintf(buffer, sizeof(buffer), "%.3f", number(m_random));
+                out += buffer;
+            }
+            else
+            {
+                std::uniform_int_distribution<size_t> index(0, m_args.size() - 1);
+                out += m_args[index(m_random)];
+            }
+        }
+
+        const char* binary()
+        {
+            switch (m_shape.mix)
+            {
+                case OperatorMix::Arithmetic:
+                    return pick({"+", "-", "*", "/"});
+                case OperatorMix::Power:
+                    return pick({"+", "*", "^"});
+                case OperatorMix::Functions:
+                    return pick({"+", "-", "*", "/"});
+            }
+            return "+";
+        }
+
+        bool chance(double p)
+        {
+            return std::bernoulli_distribution(p)(m_random);
+        }
+
+        template<size_t N>
+        const char* pick(const char* const (&options)[N])
+        {
+            return options[std::uniform_int_distribution<size_t>(0, N - 1)(m_random)];
+        }
+
+    private:
+        Shape m_shape;
+        std::mt19937_64 m_random;
+        std::vector<std::string> m_args;
+    };
+
+}
+
+void setup_bench_grammar(polishd::Grammar& grammar)
+{
+    grammar.add_constant("pi", M_PI);
+
+    // the standard operators, so that the batch evaluation runs their vectorized kernels
+    grammar.add_prefix_operator("-", polishd::kernels::negate<double>);
+    grammar.add_prefix_operator("sin", polishd::kernels::sin<double>);
+    grammar.add_prefix_operator("exp", polishd::kernels::exp<double>);
+    grammar.add_prefix_operator("abs", polishd::kernels::abs<double>);
+
+    grammar.add_binary_operator("+", polishd::kernels::add<double>, 1, polishd::Arithmetic::Add);
+    grammar.add_binary_operator("-", polishd::kernels::subtract<double>, 1, polishd::Arithmetic::Subtract);
+    grammar.add_binary_operator("*", polishd::kernels::multiply<double>, 2, polishd::Arithmetic::Multiply);
+    grammar.add_binary_operator("/", polishd::kernels::divide<double>, 2, polishd::Arithmetic::Divide);
+    grammar.add_binary_operator("^", polishd::kernels::pow<double>, 3, polishd::Arithmetic::Power);
+
+    grammar.add_postfix_operator("%", [](double x) -> double { return x / 100; });
+}
+
+std::vector<Expression> generate_corpus(unsigned long long seed)
+{
+    struct Size { size_t depth, width; };
+    constexpr Size sizes[] {{1, 4}, {1, 32}, {3, 4}, {8, 2}};
+    constexpr OperatorMix mixes[] {OperatorMix::Arithmetic, OperatorMix::Power, OperatorMix::Functions};
+
+    std::vector<Shape> shapes;
+    for (const OperatorMix mix: mixes)
+        for (const Size size: sizes)
+            shapes.push_back({mix, size.depth, size.width, 2});
+    for (const size_t args: {1, 4, 16})
+        shapes.push_back({OperatorMix::Arithmetic, 3, 4, args});
+
+    std::vector<Expression> corpus;
+    for (const Shape& shape: shapes)
+    {
+        Generator generator(shape, seed + corpus.size());
+        std::string infix = generator.generate();
+        std::string name = to_string(shape.mix)
+            + "/d" + std::to_string(shape.depth)
+            + "/w" + std::to_string(shape.width)
+            + "/a" + std::to_string(shape.args);
+        corpus.push_back({std::move(name), shape, std::move(infix), generator.args()});
+    }
+    return corpus;
+}
+
+std::string to_string(OperatorMix mix)
+{
+    switch (mix)
+    {
+        case OperatorMix::Arithmetic:
+            return "arith";
+        case OperatorMix::Power:
+            return "power";
+        case OperatorMix::Functions:
+            return "functions";
+    }
+    return "unknown";
+}
@@ -0,0 +1,44 @@
+#ifndef INC_POLISHD_BENCH_CORPUS_HPP
+#define INC_POLISHD_BENCH_CORPUS_HPP
+
+#include <string>
+#include <vector>
+
+#include <polishd.hpp>
+
+// Operators used to generate an expression
+enum class OperatorMix
+{
+    Arithmetic, // + - * /
+    Power,      // + * and ^ with small integer exponents
+    Functions   // arithmetic with prefix and postfix functions
+};
+
+struct Shape
+{
+    OperatorMix mix;
+    // Levels of nested parentheses
+    size_t depth;
+    // Operands joined by binary operators at each level
+    size_t width;
+    // Distinct arguments used in the leaves
+    size_t args;
+};
+
+struct Expression
+{
+    std::string name;
+    Shape shape;
+    std::string infix;
+    std::vector<std::string> args;
+};
+
+void setup_bench_grammar(polishd::Grammar& grammar);
+
+// Deterministically generates the benchmark expressions,
+// so that runs with the same seed are comparable
+std::vector<Expression> generate_corpus(unsigned long long seed);
+
+std::string to_string(OperatorMix mix);
+
+#endif // INC_POLISHD_BENCH_CORPUS_HPP
@@ -0,0 +1,133 @@
+#include "Report.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+
+namespace {
+
+    std::string escape(const std::string& s)
+    {
+        std::string escaped;
+        escaped.reserve(s.size() + 2);
+        escaped += '"';
+        for (const char c: s)
+        {
+            if (c == '"' || c == '\\')
+            {
+                escaped += '\\';
+                escaped += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char buffer[8];
+                std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                escaped += buffer;
+            }
+            else
+                escaped += c;
+        }
+        escaped += '"';
+        return escaped;
+    }
+
+    const char* build_type()
+    {
+#ifdef POLISHD_BENCH_BUILD_TYPE
+        return POLISHD_BENCH_BUILD_TYPE;
+#else
+        return "";
+#endif
+    }
+
+    const char* compiler()
+    {
+#ifdef __VERSION__
+        return __VERSION__;
+#else
+        return "";
+#endif
+    }
+
+}
+
+Report::Report(unsigned long long seed, std::vector<Expression> corpus) : m_seed(seed), m_corpus(std::move(corpus))
+{
+}
+
+const std::vector<Expression>& Report::corpus() const
+{
+    return m_corpus;
+}
+
+void Report::add(const Measurement& measurement)
+{
+    m_measurements.push_back(measurement);
+}
+
+void Report::print_header(std::ostream& out)
+{
+    out << std::left << std::setw(24) << "benchmark"
+        << std::setw(24) << "expression"
+        << std::right << std::setw(14) << "median ns"
+        << std::setw(14) << "min ns"
+        << std::setw(10) << "allocs"
+        << "  per" << std::endl;
+}
+
+void Report::print(std::ostream& out, const Measurement& m)
+{
+    out << std::left << std::setw(24) << m.benchmark
+        << std::setw(24) << m.expression
+        << std::right << std::fixed << std::setprecision(2)
+        << std::setw(14) << m.median_ns
+        << std::setw(14) << m.min_ns
+        << std::setw(10) << m.allocations
+        << "  " << m.unit << std::endl;
+}
+
+void Report::write_json(std::ostream& out) const
+{
+    const auto timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    out << std::setprecision(6) << std::fixed;
+    out << "{\n";
+    out << "  \"context\": {\n"
+        << "    \"timestamp\": " << timestamp << ",\n"
+        << "    \"seed\": " << m_seed << ",\n"
+        << "    \"build_type\": " << escape(build_type()) << ",\n"
+        << "    \"compiler\": " << escape(compiler()) << "\n"
+        << "  },\n";
+
+    out << "  \"corpus\": [";
+    for (size_t i = 0; i < m_corpus.size(); ++i)
+    {
+        const Expression& e = m_corpus[i];
+        out << (i ? ",\n" : "\n")
+            << "    {\"name\": " << escape(e.name)
+            << ", \"mix\": " << escape(to_string(e.shape.mix))
+            << ", \"depth\": " << e.shape.depth
+            << ", \"width\": " << e.shape.width
+            << ", \"args\": " << e.shape.args
+            << ", \"length\": " << e.infix.size()
+            << ", \"infix\": " << escape(e.infix) << "}";
+    }
+    out << "\n  ],\n";
+
+    out << "  \"results\": [";
+    for (size_t i = 0; i < m_measurements.size(); ++i)
+    {
+        const Measurement& m = m_measurements[i];
+        out << (i ? ",\n" : "\n")
+            << "    {\"benchmark\": " << escape(m.benchmark)
+            << ", \"expression\": " << escape(m.expression)
+            << ", \"unit\": " << escape(m.unit)
+            << ", \"operations\": " << m.operations
+            << ", \"median_ns\": " << m.median_ns
+            << ", \"min_ns\": " << m.min_ns
+            << ", \"allocations\": " << m.allocations << "}";
+    }
+    out << "\n  ]\n";
+    out << "}\n";
+}
@@ -0,0 +1,44 @@
+#ifndef INC_POLISHD_BENCH_REPORT_HPP
+#define INC_POLISHD_BENCH_REPORT_HPP
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Corpus.hpp"
+
+struct Measurement
+{
+    std::string benchmark;
+    std::string expression;
+    // What a single operation is, e.g. a compilation or an evaluated row
+    std::string unit;
+    size_t operations = 0;
+    double median_ns = 0;
+    double min_ns = 0;
+    double allocations = 0;
+};
+
+class Report
+{
+public:
+    Report(unsigned long long seed, std::vector<Expression> corpus);
+
+    [[nodiscard]] const std::vector<Expression>& corpus() const;
+
+    void add(const Measurement& measurement);
+
+    // Human-readable table, printed as the measurements come
+    static void print_header(std::ostream& out);
+    static void print(std::ostream& out, const Measurement& measurement);
+
+    // Machine-readable results, meant to be compared between runs
+    void write_json(std::ostream& out) const;
+
+private:
+    unsigned long long m_seed;
+    std::vector<Expression> m_corpus;
+    std::vector<Measurement> m_measurements;
+};
+
+#endif // INC_POLISHD_BENCH_REPORT_HPP
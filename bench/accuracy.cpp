@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <polishd.hpp>
+
+namespace kernels = polishd::kernels;
+
+namespace {
+
+    template<typename T>
+    using Generator = std::function<T(std::mt19937_64&)>;
+
+    void usage()
+    {
+        std::cerr <<
+            "Measures the error of the vectorized kernels against the long double standard library.\n"
+            "\n"
+            "Usage:\n"
+            "\tpolishd_accuracy [--samples N] [--seed N]\n"
+            "\n"
+            "Options:\n"
+            "\t--samples N         random arguments of each range, 1000000 by default.\n"
+            "\t--seed N            seed of the random arguments, 42 by default.\n"
+            "\n"
+            "Set POLISHD_ISA to measure the kernels of another instruction set.\n";
+    }
+
+    // Distance between `result` and the exact `reference` in units in the last place of `T`
+    template<typename T>
+    double ulps(T result, long double reference)
+    {
+        const T rounded = static_cast<T>(reference);
+        if (std::isnan(rounded) || std::isinf(rounded) || std::isnan(result) || std::isinf(result))
+            return result == rounded || (std::isnan(result) && std::isnan(rounded)) ? 0 : std::numeric_limits<double>::infinity();
+        int exponent;
+        std::frexp(rounded == T(0) ? std::numeric_limits<T>::denorm_min() : rounded, &exponent);
+        const long double ulp = std::ldexp(1.0L, std::max(exponent - std::numeric_limits<T>::digits,
+                                                          std::numeric_limits<T>::min_exponent - std::numeric_limits<T>::digits));
+        return static_cast<double>(std::fabs(static_cast<long double>(result) - reference) / ulp);
+    }
+
+    template<typename T>
+    Generator<T> uniform(double low, double high)
+    {
+        return [=](std::mt19937_64& random) { return static_cast<T>(std::uniform_real_distribution<double>(low, high)(random)); };
+    }
+
+    // Spread evenly over the exponents
+    template<typename T>
+    Generator<T> logarithmic(double low, double high)
+    {
+        return [=](std::mt19937_64& random)
+        {
+            return static_cast<T>(std::exp(std::uniform_real_distribution<double>(std::log(low), std::log(high))(random)));
+        };
+    }
+
+    // Multiples of pi/2, where the reduction of the arguments of `sin` and `cos` loses the most bits
+    template<typename T>
+    Generator<T> half_pi_multiples()
+    {
+        return [](std::mt19937_64& random)
+        {
+            return static_cast<T>(static_cast<long double>(random() % 1000000) * 1.5707963267948966192313216916397514L);
+        };
+    }
+
+    struct Accuracy
+    {
+        double max_ulps = 0;
+        double max_scalar_ulps = 0;
+        // Share of the arguments for which the kernel and the scalar operator differ
+        double mismatches = 0;
+    };
+
+    void print(std::string_view name, std::string_view type, std::string_view range, const Accuracy& accuracy)
+    {
+        std::printf("%-6s %-8s %-24s %10.3f %10.3f %10.2f%%\n", name.data(), type.data(), range.data(),
+                    accuracy.max_ulps, accuracy.max_scalar_ulps, 100 * accuracy.mismatches);
+    }
+
+    template<typename T>
+    Accuracy measure(const std::vector<T>& results, const std::vector<T>& scalar_results, const std::vector<long double>& references)
+    {
+        Accuracy accuracy;
+        size_t mismatches = 0;
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            accuracy.max_ulps = std::max(accuracy.max_ulps, ulps(results[i], references[i]));
+            accuracy.max_scalar_ulps = std::max(accuracy.max_scalar_ulps, ulps(scalar_results[i], references[i]));
+            mismatches += results[i] != scalar_results[i] && !(std::isnan(results[i]) && std::isnan(scalar_results[i]));
+        }
+        accuracy.mismatches = static_cast<double>(mismatches) / static_cast<double>(results.size());
+        return accuracy;
+    }
+
+    template<typename T>
+    void unary(std::string_view name, kernels::Unary<T> scalar, long double (*reference)(long double),
+               std::string_view range, const Generator<T>& generate, size_t samples, unsigned long long seed)
+    {
+        std::mt19937_64 random(seed);
+        std::vector<T> x(samples), results(samples), scalar_results(samples);
+        std::vector<long double> references(samples);
+        for (T& value: x)
+            value = generate(random);
+        kernels::find<T>(scalar)(x.data(), results.data(), samples);
+        for (size_t i = 0; i < samples; ++i)
+        {
+            scalar_results[i] = scalar(x[i]);
+            references[i] = reference(x[i]);
+        }
+        print(name, sizeof(T) == sizeof(float) ? "float" : "double", range, measure(results, scalar_results, references));
+    }
+
+    template<typename T>
+    void pow(std::string_view range, const Generator<T>& base, const Generator<T>& exponent, size_t samples, unsigned long long seed)
+    {
+        const kernels::BinaryKernel<T> kernel = kernels::find<T>(&kernels::pow<T>);
+        if (!kernel)
+            return;
+        std::mt19937_64 random(seed);
+        std::vector<T> a(samples), b(samples), results(samples), scalar_results(samples);
+        std::vector<long double> references(samples);
+        for (size_t i = 0; i < samples; ++i)
+        {
+            a[i] = base(random);
+            b[i] = exponent(random);
+        }
+        kernel(a.data(), b.data(), results.data(), samples);
+        for (size_t i = 0; i < samples; ++i)
+        {
+            scalar_results[i] = kernels::pow(a[i], b[i]);
+            references[i] = std::pow(static_cast<long double>(a[i]), static_cast<long double>(b[i]));
+        }
+        print("pow", sizeof(T) == sizeof(float) ? "float" : "double", range, measure(results, scalar_results, references));
+    }
+
+    template<typename T>
+    void measure_all(size_t samples, unsigned long long seed)
+    {
+        unary<T>("exp", &kernels::exp<T>, expl, "[-750, 750]", uniform<T>(-750, 750), samples, seed);
+        unary<T>("exp", &kernels::exp<T>, expl, "[-1, 1]", uniform<T>(-1, 1), samples, seed);
+        unary<T>("log", &kernels::log<T>, logl, "[1e-300, 1e300] log", logarithmic<T>(1e-300, 1e300), samples, seed);
+        unary<T>("log", &kernels::log<T>, logl, "[0.5, 2]", uniform<T>(0.5, 2), samples, seed);
+        unary<T>("sin", &kernels::sin<T>, sinl, "[-10, 10]", uniform<T>(-10, 10), samples, seed);
+        unary<T>("sin", &kernels::sin<T>, sinl, "[1e-9, 2e6] log", logarithmic<T>(1e-9, 2e6), samples, seed);
+        unary<T>("sin", &kernels::sin<T>, sinl, "k * pi/2", half_pi_multiples<T>(), samples, seed);
+        unary<T>("cos", &kernels::cos<T>, cosl, "[-10, 10]", uniform<T>(-10, 10), samples, seed);
+        unary<T>("cos", &kernels::cos<T>, cosl, "[1e-9, 2e6] log", logarithmic<T>(1e-9, 2e6), samples, seed);
+        unary<T>("cos", &kernels::cos<T>, cosl, "k * pi/2", half_pi_multiples<T>(), samples, seed);
+        pow<T>("[1e-5, 1e5] ^ [-50, 50]", logarithmic<T>(1e-5, 1e5), uniform<T>(-50, 50), samples, seed);
+        pow<T>("[0.5, 2] ^ [-1000, 1000]", uniform<T>(0.5, 2), uniform<T>(-1000, 1000), samples, seed);
+        pow<T>("[1e-300, 1e300] ^ [-2, 2]", logarithmic<T>(1e-300, 1e300), uniform<T>(-2, 2), samples, seed);
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    size_t samples = 1000000;
+    unsigned long long seed = 42;
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg = argv[i];
+            if (i + 1 == argc)
+                throw std::invalid_argument("missing a value for '" + std::string(arg) + "'");
+            const std::string value = argv[++i];
+            if (arg == "--samples")
+                samples = std::max<size_t>(1, std::stoul(value));
+            else if (arg == "--seed")
+                seed = std::stoull(value);
+            else
+                throw std::invalid_argument("unexpected option '" + std::string(arg) + "'");
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << "\n\n";
+        usage();
+        return 2;
+    }
+
+    std::printf("kernels: %s\n", kernels::instruction_set());
+    std::printf("%-6s %-8s %-24s %10s %10s %11s\n", "kernel", "type", "arguments", "max ulp", "libm ulp", "vs libm");
+    measure_all<double>(samples, seed);
+    measure_all<float>(samples, seed);
+}
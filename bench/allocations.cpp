@@ -0,0 +1,54 @@
+#include "allocations.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replacing the global allocation functions lets the benchmark
+// count the allocations made by the library without any hooks in it.
+
+namespace {
+
+    std::atomic<size_t> g_count {0};
+
+    void* allocate(size_t size)
+    {
+        g_count.fetch_add(1, std::memory_order_relaxed);
+        if (void* p = std::malloc(size ? size : 1))
+            return p;
+        throw std::bad_alloc();
+    }
+
+    void* allocate(size_t size, std::align_val_t alignment)
+    {
+        g_count.fetch_add(1, std::memory_order_relaxed);
+        const auto align = static_cast<size_t>(alignment);
+        if (void* p = std::aligned_alloc(align, (size + align - 1) / align * align))
+            return p;
+        throw std::bad_alloc();
+    }
+
+}
+
+namespace allocations {
+
+    size_t count()
+    {
+        return g_count.load(std::memory_order_relaxed);
+    }
+
+} // namespace allocations
+
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+void* operator new(size_t size, std::align_val_t alignment) { return allocate(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return allocate(size, alignment); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
@@ -0,0 +1,13 @@
+#ifndef INC_POLISHD_BENCH_ALLOCATIONS_HPP
+#define INC_POLISHD_BENCH_ALLOCATIONS_HPP
+
+#include <cstddef>
+
+namespace allocations {
+
+    // Number of calls to the global `operator new` made so far by all threads
+    size_t count();
+
+} // namespace allocations
+
+#endif // INC_POLISHD_BENCH_ALLOCATIONS_HPP
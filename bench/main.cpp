@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <polishd.hpp>
+
+#include "allocations.hpp"
+#include "Corpus.hpp"
+#include "Report.hpp"
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    // Rows per call of the batch evaluation
+    constexpr size_t BatchRows = 4096;
+
+    struct Options
+    {
+        std::string output = "polishd_bench.json";
+        std::string filter;
+        double min_time_ms = 200;
+        size_t repetitions = 5;
+        unsigned long long seed = 42;
+    };
+
+    // Keeps the benchmarked results observable, so they are not optimized away
+    volatile double g_sink;
+
+    void usage()
+    {
+        std::cerr <<
+            "Benchmarks compilation and evaluation of a generated expression corpus.\n"
+            "\n"
+            "Usage:\n"
+            "\tpolishd_bench [--output FILE] [--filter TEXT] [--min-time MS] [--repetitions N] [--seed N]\n"
+            "\n"
+            "Options:\n"
+            "\t--output FILE       JSON results file, polishd_bench.json by default.\n"
+            "\t--filter TEXT       run only the benchmarks whose `benchmark/expression` name contains TEXT.\n"
+            "\t--min-time MS       minimal total measured time of each benchmark, 200 by default.\n"
+            "\t--repetitions N     number of measured samples of each benchmark, 5 by default.\n"
+            "\t--seed N            seed of the generated corpus, 42 by default.\n";
+    }
+
+    Options parse_options(int argc, char** argv)
+    {
+        Options options;
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg = argv[i];
+            if (i + 1 == argc)
+                throw std::invalid_argument("missing a value for '" + std::string(arg) + "'");
+            const std::string value = argv[++i];
+            if (arg == "--output")
+                options.output = value;
+            else if (arg == "--filter")
+                options.filter = value;
+            else if (arg == "--min-time")
+                options.min_time_ms = std::stod(value);
+            else if (arg == "--repetitions")
+                options.repetitions = std::max<size_t>(1, std::stoul(value));
+            else if (arg == "--seed")
+                options.seed = std::stoull(value);
+            else
+                throw std::invalid_argument("unexpected option '" + std::string(arg) + "'");
+        }
+        return options;
+    }
+
+    class Runner
+    {
+    public:
+        Runner(const Options& options, Report& report) : m_options(options), m_report(report)
+        {
+        }
+
+        // Runs `body` in `repetitions` samples of a calibrated number of iterations.
+        // Each call of `body` performs `operations` operations of the given `unit`.
+        template<typename Body>
+        void run(const std::string& benchmark, const Expression& expression,
+                 const std::string& unit, size_t operations, Body&& body)
+        {
+            const std::string name = benchmark + "/" + expression.name;
+            if (name.find(m_options.filter) == std::string::npos)
+                return;
+
+            const auto sample_time = std::chrono::duration<double, std::milli>(m_options.min_time_ms / m_options.repetitions);
+            size_t iterations = 1;
+            while (time(body, iterations) < sample_time && iterations < (1ull << 40))
+                iterations *= 2;
+
+            std::vector<double> samples;
+            const size_t allocations_before = allocations::count();
+            for (size_t i = 0; i < m_options.repetitions; ++i)
+            {
+                const std::chrono::duration<double, std::nano> elapsed = time(body, iterations);
+                samples.push_back(elapsed.count() / static_cast<double>(iterations * operations));
+            }
+            const size_t allocations = allocations::count() - allocations_before;
+
+            std::sort(samples.begin(), samples.end());
+            const Measurement measurement {
+                .benchmark = benchmark,
+                .expression = expression.name,
+                .unit = unit,
+                .operations = iterations * operations * m_options.repetitions,
+                .median_ns = samples[samples.size() / 2],
+                .min_ns = samples.front(),
+                .allocations = static_cast<double>(allocations) / static_cast<double>(iterations * operations * m_options.repetitions)
+            };
+            Report::print(std::cout, measurement);
+            m_report.add(measurement);
+        }
+
+    private:
+        template<typename Body>
+        static Clock::duration time(Body& body, size_t iterations)
+        {
+            const auto start = Clock::now();
+            for (size_t i = 0; i < iterations; ++i)
+                body();
+            return Clock::now() - start;
+        }
+
+    private:
+        const Options& m_options;
+        Report& m_report;
+    };
+
+    void benchmark_compile(Runner& runner, const polishd::Grammar& grammar, const Expression& expression)
+    {
+        runner.run("compile", expression, "compilation", 1, [&]
+        {
+            const polishd::Function f = polishd::compile(grammar, expression.infix);
+            g_sink = static_cast<double>(f.postfix().size());
+        });
+    }
+
+    void benchmark_scalar(Runner& runner, const polishd::Function& f, const Expression& expression)
+    {
+        polishd::Args args;
+        for (size_t i = 0; i < expression.args.size(); ++i)
+            args[expression.args[i]] = 1.0 + 0.01 * static_cast<double>(i);
+
+        runner.run("evaluate/scalar", expression, "evaluation", 1, [&]
+        {
+            g_sink = f.evaluate(args);
+        });
+    }
+
+    void benchmark_batch(Runner& runner, const polishd::Function& f, const Expression& expression,
+                         const std::string& benchmark = "evaluate/batch")
+    {
+        std::vector<std::vector<double>> values(expression.args.size(), std::vector<double>(BatchRows));
+        polishd::Columns columns;
+        for (size_t i = 0; i < expression.args.size(); ++i)
+        {
+            for (size_t row = 0; row < BatchRows; ++row)
+                values[i][row] = 1.0 + 0.001 * static_cast<double>((row + i) % 1000);
+            columns[expression.args[i]] = values[i].data();
+        }
+        std::vector<double> out(BatchRows);
+
+        runner.run(benchmark, expression, "row", BatchRows, [&]
+        {
+            f.evaluate(columns, out.data(), BatchRows);
+            g_sink = out[BatchRows - 1];
+        });
+    }
+
+    void benchmark_reduce(Runner& runner, const polishd::Function& f, const Expression& expression)
+    {
+        std::vector<std::vector<double>> values(expression.args.size(), std::vector<double>(BatchRows));
+        polishd::Columns columns;
+        for (size_t i = 0; i < expression.args.size(); ++i)
+        {
+            for (size_t row = 0; row < BatchRows; ++row)
+                values[i][row] = 1.0 + 0.001 * static_cast<double>((row + i) % 1000);
+            columns[expression.args[i]] = values[i].data();
+        }
+
+        runner.run("reduce/sum", expression, "row", BatchRows, [&]
+        {
+            g_sink = f.reduce(columns, BatchRows, polishd::Reduction::sum());
+        });
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    try
+    {
+        options = parse_options(argc, argv);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << "\n\n";
+        usage();
+        return 2;
+    }
+
+    polishd::Grammar grammar;
+    setup_bench_grammar(grammar);
+    Report report(options.seed, generate_corpus(options.seed));
+    Runner runner(options, report);
+
+    Report::print_header(std::cout);
+    for (const Expression& expression: report.corpus())
+    {
+        const polishd::Function f = polishd::compile(grammar, expression.infix);
+        benchmark_compile(runner, grammar, expression);
+        benchmark_scalar(runner, f, expression);
+        benchmark_batch(runner, f, expression);
+        // the same without the arithmetic rewrites, which should only ever make it faster
+        const polishd::Function strict = polishd::compile(grammar, expression.infix, {.strict_ieee = true});
+        benchmark_batch(runner, strict, expression, "evaluate/batch/strict");
+        benchmark_reduce(runner, f, expression);
+    }
+
+    std::ofstream output(options.output);
+    if (!output)
+    {
+        std::cerr << "Error: failed to open '" << options.output << "' for writing" << std::endl;
+        return 1;
+    }
+    report.write_json(output);
+}
@@ -0,0 +1,163 @@
+#include "Description.hpp"
+
+#include <array>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+    // The generator tells the operators apart by their functions,
+    // so each operator gets a distinct one from a fixed pool
+    constexpr size_t MaxOperators = 256;
+
+    template<size_t I>
+    double unary_placeholder(double a)
+    {
+        return a + static_cast<double>(I);
+    }
+
+    template<size_t I>
+    double binary_placeholder(double a, double b)
+    {
+        return a * b + static_cast<double>(I);
+    }
+
+    template<size_t... I>
+    constexpr std::array<polishd::Grammar::Unary, sizeof...(I)> make_unary_placeholders(std::index_sequence<I...>)
+    {
+        return {&unary_placeholder<I>...};
+    }
+
+    template<size_t... I>
+    constexpr std::array<polishd::Grammar::Binary, sizeof...(I)> make_binary_placeholders(std::index_sequence<I...>)
+    {
+        return {&binary_placeholder<I>...};
+    }
+
+    constexpr auto UnaryPlaceholders = make_unary_placeholders(std::make_index_sequence<MaxOperators>());
+    constexpr auto BinaryPlaceholders = make_binary_placeholders(std::make_index_sequence<MaxOperators>());
+
+    polishd::Arithmetic parse_arithmetic(const std::string& s)
+    {
+        if (s == "-")
+            return polishd::Arithmetic::None;
+        if (s == "add")
+            return polishd::Arithmetic::Add;
+        if (s == "subtract")
+            return polishd::Arithmetic::Subtract;
+        if (s == "multiply")
+            return polishd::Arithmetic::Multiply;
+        if (s == "divide")
+            return polishd::Arithmetic::Divide;
+        if (s == "power")
+            return polishd::Arithmetic::Power;
+        throw std::invalid_argument("unknown arithmetic '" + s + "'");
+    }
+
+    // The rest of the line without the leading spaces
+    std::string rest(std::istringstream& line)
+    {
+        std::string s;
+        std::getline(line >> std::ws, s);
+        return s;
+    }
+
+    Description::Operator parse_unary(std::istringstream& line)
+    {
+        Description::Operator op;
+        line >> op.signature;
+        op.code = rest(line);
+        if (op.code.empty())
+            throw std::invalid_argument("expected 'prefix|postfix SIGNATURE CODE'");
+        return op;
+    }
+
+    Description::Operator parse_binary(std::istringstream& line)
+    {
+        Description::Operator op;
+        std::string arithmetic;
+        // read as a number rather than a character
+        unsigned precedence = 0;
+        line >> op.signature >> precedence >> arithmetic;
+        op.precedence = static_cast<polishd::Grammar::Precedence>(precedence);
+        op.code = rest(line);
+        if (op.code.empty())
+            throw std::invalid_argument("expected 'binary SIGNATURE PRECEDENCE ARITHMETIC CODE'");
+        op.arithmetic = parse_arithmetic(arithmetic);
+        return op;
+    }
+
+}
+
+Description Description::parse(std::istream& in)
+{
+    Description description;
+    std::string text;
+    for (size_t number = 1; std::getline(in, text); ++number)
+    {
+        std::istringstream line(text);
+        std::string directive;
+        line >> directive;
+        if (directive.empty() || directive[0] == '#')
+            continue;
+        try
+        {
+            if (directive == "constant")
+            {
+                Constant constant;
+                line >> constant.name >> constant.value;
+                if (!line)
+                    throw std::invalid_argument("expected 'constant NAME VALUE'");
+                description.constants.push_back(constant);
+            }
+            else if (directive == "prefix")
+                description.prefix.push_back(parse_unary(line));
+            else if (directive == "postfix")
+                description.postfix.push_back(parse_unary(line));
+            else if (directive == "binary")
+                description.binary.push_back(parse_binary(line));
+            else if (directive == "function")
+            {
+                Expression expression;
+                std::string equals;
+                line >> expression.name >> equals;
+                if (equals != "=")
+                    throw std::invalid_argument("expected 'function NAME = EXPRESSION'");
+                expression.infix = rest(line);
+                description.expressions.push_back(expression);
+            }
+            else
+                throw std::invalid_argument("unknown directive '" + directive + "'");
+        }
+        catch (const std::invalid_argument& e)
+        {
+            throw std::invalid_argument("line " + std::to_string(number) + ": " + e.what());
+        }
+    }
+    return description;
+}
+
+void Description::setup(polishd::Grammar& grammar, polishd::CodeGenerator& generator) const
+{
+    if (prefix.size() + postfix.size() > MaxOperators || binary.size() > MaxOperators)
+        throw std::invalid_argument("too many operators, at most " + std::to_string(MaxOperators) + " of each arity are supported");
+
+    for (const Constant& constant: constants)
+        grammar.add_constant(constant.name, constant.value);
+
+    size_t unary = 0;
+    for (const Operator& op: prefix)
+        grammar.add_prefix_operator(op.signature, UnaryPlaceholders[unary++]);
+    for (const Operator& op: postfix)
+        grammar.add_postfix_operator(op.signature, UnaryPlaceholders[unary++]);
+    for (size_t i = 0; i < binary.size(); ++i)
+        grammar.add_binary_operator(binary[i].signature, BinaryPlaceholders[i], binary[i].precedence, binary[i].arithmetic);
+
+    for (const Operator& op: prefix)
+        generator.add_prefix_code(op.signature, op.code);
+    for (const Operator& op: postfix)
+        generator.add_postfix_code(op.signature, op.code);
+    for (const Operator& op: binary)
+        generator.add_binary_code(op.signature, op.code);
+}
@@ -0,0 +1,60 @@
+#ifndef INC_POLISHD_CODEGEN_DESCRIPTION_HPP
+#define INC_POLISHD_CODEGEN_DESCRIPTION_HPP
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include <polishd.hpp>
+
+// A grammar along with the C++ code of its operators and the expressions to generate, e.g.
+//
+//   # comment
+//   constant pi 3.141592653589793
+//   prefix - -a
+//   prefix sin std::sin(a)
+//   postfix ! std::tgamma(a + 1)
+//   binary + 1 add a + b
+//   binary ^ 3 power std::pow(a, b)
+//   binary max 0 - std::max(a, b)
+//   function area = pi * r^2
+//
+// A binary operator is marked with an `Arithmetic` kind (`add`, `subtract`, `multiply`, `divide`, `power`)
+// or `-` for none. The code is the rest of the line.
+struct Description
+{
+    struct Constant
+    {
+        std::string name;
+        double value;
+    };
+
+    struct Operator
+    {
+        std::string signature;
+        std::string code;
+        polishd::Grammar::Precedence precedence = 0;
+        polishd::Arithmetic arithmetic = polishd::Arithmetic::None;
+    };
+
+    struct Expression
+    {
+        std::string name;
+        std::string infix;
+    };
+
+    std::vector<Constant> constants;
+    std::vector<Operator> prefix;
+    std::vector<Operator> postfix;
+    std::vector<Operator> binary;
+    std::vector<Expression> expressions;
+
+    // Throws `std::invalid_argument` with the line number on malformed input
+    static Description parse(std::istream& in);
+
+    // The operators get placeholder functions:
+    // the expressions are only compiled to generate code, never evaluated
+    void setup(polishd::Grammar& grammar, polishd::CodeGenerator& generator) const;
+};
+
+#endif // INC_POLISHD_CODEGEN_DESCRIPTION_HPP
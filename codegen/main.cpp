@@ -0,0 +1,115 @@
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <polishd.hpp>
+
+#include "Description.hpp"
+
+namespace {
+
+    struct Options
+    {
+        std::string description;
+        std::string output;
+        std::string name_space = "generated";
+        polishd::CompileOptions compile;
+    };
+
+    void usage()
+    {
+        std::cerr <<
+            "Generates a C++ header with one inline function per expression of a grammar description.\n"
+            "\n"
+            "Usage:\n"
+            "\tpolishd_codegen DESCRIPTION -o HEADER [--namespace NAME] [--strict-ieee]\n"
+            "\n"
+            "Options:\n"
+            "\t-o HEADER           the header to write.\n"
+            "\t--namespace NAME    namespace of the generated functions, `generated` by default.\n"
+            "\t--strict-ieee       disable the rewrites that may change the rounding, see `CompileOptions`.\n"
+            "\n"
+            "The description lists the constants, the operators along with their C++ code, and the expressions:\n"
+            "\n"
+            "\tconstant pi 3.141592653589793\n"
+            "\tprefix - -a\n"
+            "\tprefix sin std::sin(a)\n"
+            "\tpostfix ! std::tgamma(a + 1)\n"
+            "\tbinary + 1 add a + b\n"
+            "\tbinary * 2 multiply a * b\n"
+            "\tbinary ^ 3 power std::pow(a, b)\n"
+            "\tbinary max 0 - std::max(a, b)\n"
+            "\tfunction area = pi * r^2\n";
+    }
+
+    Options parse_options(int argc, char** argv)
+    {
+        Options options;
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg = argv[i];
+            if (arg == "--strict-ieee")
+                options.compile.strict_ieee = true;
+            else if (arg == "-o" || arg == "--namespace")
+            {
+                if (i + 1 == argc)
+                    throw std::invalid_argument("missing a value for '" + std::string(arg) + "'");
+                (arg == "-o" ? options.output : options.name_space) = argv[++i];
+            }
+            else if (options.description.empty())
+                options.description = arg;
+            else
+                throw std::invalid_argument("unexpected argument '" + std::string(arg) + "'");
+        }
+        if (options.description.empty() || options.output.empty())
+            throw std::invalid_argument("expected a description and an output header");
+        return options;
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    try
+    {
+        options = parse_options(argc, argv);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << "\n\n";
+        usage();
+        return 2;
+    }
+
+    try
+    {
+        std::ifstream input(options.description);
+        if (!input)
+            throw std::runtime_error("failed to open '" + options.description + "'");
+        const Description description = Description::parse(input);
+
+        polishd::Grammar grammar;
+        polishd::CodeGenerator generator(grammar);
+        description.setup(grammar, generator);
+        for (const Description::Expression& expression: description.expressions)
+        {
+            const polishd::Expected<polishd::Function> f = polishd::try_compile(grammar, expression.infix, options.compile);
+            if (!f)
+                throw std::runtime_error("function '" + expression.name + "': " + f.error().message(expression.infix));
+            generator.add_function(expression.name, *f);
+        }
+
+        std::ofstream output(options.output);
+        if (!output)
+            throw std::runtime_error("failed to open '" + options.output + "' for writing");
+        generator.write(output, options.name_space);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << options.description << ": " << e.what() << std::endl;
+        return 1;
+    }
+}
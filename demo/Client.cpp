@@ -0,0 +1,147 @@
+#include "Client.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+    [[noreturn]] void fail(const std::string& what)
+    {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+}
+
+Client::Client(const std::string& socket_path)
+{
+    sockaddr_un address {.sun_family = AF_UNIX, .sun_path = {}};
+    if (socket_path.size() >= sizeof(address.sun_path))
+        throw std::invalid_argument("the socket path is too long");
+    std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+    m_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_fd == -1)
+        fail("socket");
+    if (connect(m_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == -1)
+    {
+        ::close(m_fd);
+        fail("connect " + socket_path);
+    }
+}
+
+Client::~Client()
+{
+    ::close(m_fd);
+}
+
+std::vector<std::string> Client::compile(std::string_view name, std::string_view infix)
+{
+    protocol::Writer w = writer(protocol::Request::Compile);
+    w.string(name);
+    w.string(infix);
+    const std::vector<std::byte> payload = request(std::move(w));
+
+    protocol::Reader reader(payload.data(), payload.size());
+    std::vector<std::string> arguments(reader.u32());
+    for (std::string& argument: arguments)
+        argument = reader.string();
+    return arguments;
+}
+
+void Client::evaluate(std::string_view name, const double* columns, size_t column_count, size_t rows, double* out)
+{
+    protocol::Writer w = writer(protocol::Request::Evaluate);
+    w.string(name);
+    w.u32(static_cast<uint32_t>(rows));
+    w.u32(static_cast<uint32_t>(column_count));
+    w.doubles(columns, column_count * rows);
+    const std::vector<std::byte> payload = request(std::move(w));
+
+    protocol::Reader reader(payload.data(), payload.size());
+    std::memcpy(out, reader.doubles(rows), rows * sizeof(double));
+}
+
+void Client::remove(std::string_view name)
+{
+    protocol::Writer w = writer(protocol::Request::Delete);
+    w.string(name);
+    request(std::move(w));
+}
+
+auto Client::list() -> std::vector<Saved>
+{
+    const std::vector<std::byte> payload = request(writer(protocol::Request::List));
+
+    protocol::Reader reader(payload.data(), payload.size());
+    std::vector<Saved> functions(reader.u32());
+    for (Saved& saved: functions)
+    {
+        saved.name = reader.string();
+        saved.infix = reader.string();
+        saved.arguments.resize(reader.u32());
+        for (std::string& argument: saved.arguments)
+            argument = reader.string();
+    }
+    return functions;
+}
+
+std::vector<std::byte> Client::request(protocol::Writer&& writer)
+{
+    send(std::move(writer).finish());
+
+    protocol::Header header;
+    receive(reinterpret_cast<std::byte*>(&header), sizeof(header));
+    if (header.size > protocol::MaxMessageSize)
+        throw protocol::Error("the response is too large");
+    std::vector<std::byte> payload(header.size);
+    receive(payload.data(), payload.size());
+
+    if (static_cast<protocol::Status>(header.status) != protocol::Status::Ok)
+    {
+        protocol::Reader reader(payload.data(), payload.size());
+        throw protocol::Error(std::string(reader.string()));
+    }
+    return payload;
+}
+
+void Client::send(const std::vector<std::byte>& message)
+{
+    for (size_t offset = 0; offset < message.size();)
+    {
+        const ssize_t sent = ::send(m_fd, message.data() + offset, message.size() - offset, MSG_NOSIGNAL);
+        if (sent == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            fail("send");
+        }
+        offset += sent;
+    }
+}
+
+void Client::receive(std::byte* data, size_t size)
+{
+    for (size_t offset = 0; offset < size;)
+    {
+        const ssize_t received = read(m_fd, data + offset, size - offset);
+        if (received == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            fail("read");
+        }
+        if (received == 0)
+            throw protocol::Error("the daemon closed the connection");
+        offset += received;
+    }
+}
+
+protocol::Writer Client::writer(protocol::Request request)
+{
+    return protocol::Writer(m_next_id++, request);
+}
@@ -0,0 +1,53 @@
+#ifndef INC_POLISHD_DEMO_CLIENT_HPP
+#define INC_POLISHD_DEMO_CLIENT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Protocol.hpp"
+
+// A blocking client of the `polishdd` daemon, one request at a time.
+// Throws `protocol::Error` with the message of the daemon if a request fails.
+class Client
+{
+public:
+    explicit Client(const std::string& socket_path);
+    ~Client();
+
+    Client(const Client&) = delete;
+    Client& operator=(const Client&) = delete;
+
+    // Saves the expression as `name` and returns the names of its arguments in the order of the columns
+    std::vector<std::string> compile(std::string_view name, std::string_view infix);
+
+    // `columns` holds the values of each argument, `rows` each, one column after another
+    void evaluate(std::string_view name, const double* columns, size_t column_count, size_t rows, double* out);
+
+    void remove(std::string_view name);
+
+    struct Saved
+    {
+        std::string name;
+        std::string infix;
+        std::vector<std::string> arguments;
+    };
+
+    std::vector<Saved> list();
+
+private:
+    // Sends the request and returns the payload of a successful response
+    std::vector<std::byte> request(protocol::Writer&& writer);
+    void send(const std::vector<std::byte>& message);
+    void receive(std::byte* data, size_t size);
+
+    protocol::Writer writer(protocol::Request request);
+
+private:
+    int m_fd = -1;
+    uint32_t m_next_id = 1;
+};
+
+#endif // INC_POLISHD_DEMO_CLIENT_HPP
@@ -0,0 +1,77 @@
+#include "MappedFile.hpp"
+
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    std::runtime_error system_error(const std::string& what, const std::string& path)
+    {
+        return std::runtime_error(what + " '" + path + "': " + std::strerror(errno));
+    }
+}
+
+MappedFile::MappedFile(const std::string& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw system_error("Failed to open", path);
+
+    struct stat info {};
+    if (::fstat(fd, &info) < 0)
+    {
+        ::close(fd);
+        throw system_error("Failed to stat", path);
+    }
+    m_size = static_cast<size_t>(info.st_size);
+
+    if (m_size > 0)
+    {
+        void* mapping = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            ::close(fd);
+            throw system_error("Failed to map", path);
+        }
+        ::madvise(mapping, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const char*>(mapping);
+    }
+    ::close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data)
+        ::munmap(const_cast<char*>(m_data), m_size);
+}
+
+const char* MappedFile::data() const
+{
+    return m_data;
+}
+
+size_t MappedFile::size() const
+{
+    return m_size;
+}
+
+std::string_view MappedFile::view() const
+{
+    return {m_data, m_size};
+}
+
+void MappedFile::release(size_t offset)
+{
+    static const auto page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t end = offset / page_size * page_size;
+    if (end <= m_released)
+        return;
+    ::madvise(const_cast<char*>(m_data) + m_released, end - m_released, MADV_DONTNEED);
+    m_released = end;
+}
@@ -0,0 +1,33 @@
+#ifndef INC_POLISHD_DEMO_MAPPED_FILE_HPP
+#define INC_POLISHD_DEMO_MAPPED_FILE_HPP
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+// A read-only memory mapping of a whole file.
+// Pages that were already consumed could be released
+// so that streaming through a huge file keeps the resident memory bounded.
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] const char* data() const;
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] std::string_view view() const;
+
+    // Tells the OS that the bytes before `offset` won't be accessed anymore
+    void release(size_t offset);
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_released = 0;
+};
+
+#endif // INC_POLISHD_DEMO_MAPPED_FILE_HPP
@@ -0,0 +1,98 @@
+#include "Protocol.hpp"
+
+#include <cstring>
+
+namespace protocol {
+
+    namespace {
+
+        size_t align(size_t offset)
+        {
+            return (offset + alignof(double) - 1) & ~(alignof(double) - 1);
+        }
+
+    }
+
+    Writer::Writer(uint32_t id, Request request, Status status)
+    {
+        const Header header {
+            .size = 0,
+            .id = id,
+            .request = static_cast<uint32_t>(request),
+            .status = static_cast<uint32_t>(status)
+        };
+        std::memcpy(append(sizeof(header)), &header, sizeof(header));
+    }
+
+    void Writer::u32(uint32_t value)
+    {
+        std::memcpy(append(sizeof(value)), &value, sizeof(value));
+    }
+
+    void Writer::string(std::string_view s)
+    {
+        u32(static_cast<uint32_t>(s.size()));
+        std::memcpy(append(s.size()), s.data(), s.size());
+    }
+
+    double* Writer::doubles(size_t count)
+    {
+        // the header size is a multiple of 8, so aligning the whole message aligns the payload too
+        m_buffer.resize(align(m_buffer.size()));
+        return reinterpret_cast<double*>(append(count * sizeof(double)));
+    }
+
+    void Writer::doubles(const double* values, size_t count)
+    {
+        std::memcpy(doubles(count), values, count * sizeof(double));
+    }
+
+    std::vector<std::byte> Writer::finish() &&
+    {
+        const uint32_t size = static_cast<uint32_t>(m_buffer.size() - sizeof(Header));
+        std::memcpy(m_buffer.data() + offsetof(Header, size), &size, sizeof(size));
+        return std::move(m_buffer);
+    }
+
+    std::byte* Writer::append(size_t size)
+    {
+        const size_t offset = m_buffer.size();
+        m_buffer.resize(offset + size);
+        return m_buffer.data() + offset;
+    }
+
+    Reader::Reader(const std::byte* payload, size_t size) : m_payload(payload), m_size(size)
+    {
+    }
+
+    uint32_t Reader::u32()
+    {
+        uint32_t value;
+        std::memcpy(&value, take(sizeof(value)), sizeof(value));
+        return value;
+    }
+
+    std::string_view Reader::string()
+    {
+        const uint32_t size = u32();
+        return {reinterpret_cast<const char*>(take(size)), size};
+    }
+
+    const double* Reader::doubles(size_t count)
+    {
+        take(align(m_offset) - m_offset);
+        if (count > (m_size - m_offset) / sizeof(double))
+            throw Error("the message is too short");
+        return reinterpret_cast<const double*>(take(count * sizeof(double)));
+    }
+
+    const std::byte* Reader::take(size_t size)
+    {
+        if (size > m_size - m_offset)
+            throw Error("the message is too short");
+        const std::byte* const data = m_payload + m_offset;
+        m_offset += size;
+        return data;
+    }
+
+}
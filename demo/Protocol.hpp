@@ -0,0 +1,109 @@
+#ifndef INC_POLISHD_DEMO_PROTOCOL_HPP
+#define INC_POLISHD_DEMO_PROTOCOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// The binary protocol of the `polishdd` daemon.
+// Both sides are on the same host, so the values are in the native byte order.
+//
+// Every message is a `Header` followed by `Header::size` bytes of payload.
+// The payload is a sequence of fields:
+// * `u32` - a 4-byte unsigned integer;
+// * `string` - a `u32` length and the bytes;
+// * `doubles` - zero padding up to a multiple of 8 bytes from the payload start and the values,
+//   so that the values could be read in place.
+//
+// Requests and their responses with `Status::Ok`:
+// * `Compile`: string name, string infix -> u32 count, `count` strings of the argument names;
+// * `Evaluate`: string name, u32 rows, u32 columns, doubles of `columns` columns of `rows` values
+//   in the order of the argument names -> doubles of `rows` results;
+// * `Delete`: string name -> nothing;
+// * `List`: nothing -> u32 count, `count` times: string name, string infix,
+//   u32 arguments, `arguments` strings of the argument names.
+// A response with `Status::Error` has a string message instead.
+namespace protocol {
+
+    // Larger messages are rejected, and the connection is closed
+    constexpr uint32_t MaxMessageSize = 1u << 28;
+
+    enum class Request : uint32_t
+    {
+        Compile = 1,
+        Evaluate,
+        Delete,
+        List
+    };
+
+    enum class Status : uint32_t
+    {
+        Ok = 0,
+        Error
+    };
+
+    struct Header
+    {
+        uint32_t size = 0;
+        // Chosen by the client and echoed in the response,
+        // as the responses to pipelined requests may come out of order
+        uint32_t id = 0;
+        uint32_t request = 0;
+        uint32_t status = 0;
+    };
+    static_assert(sizeof(Header) == 16);
+
+    class Error : public std::runtime_error
+    {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    // Builds a whole message, the header included
+    class Writer
+    {
+    public:
+        Writer(uint32_t id, Request request, Status status = Status::Ok);
+
+        void u32(uint32_t value);
+        void string(std::string_view s);
+        // Appends `count` uninitialized values to be filled in place.
+        // The pointer is valid until the next write.
+        double* doubles(size_t count);
+        void doubles(const double* values, size_t count);
+
+        // Sets the payload size in the header
+        [[nodiscard]] std::vector<std::byte> finish() &&;
+
+    private:
+        std::byte* append(size_t size);
+
+    private:
+        std::vector<std::byte> m_buffer;
+    };
+
+    // Reads the fields of a payload, throws `Error` if it is too short
+    class Reader
+    {
+    public:
+        Reader(const std::byte* payload, size_t size);
+
+        uint32_t u32();
+        std::string_view string();
+        const double* doubles(size_t count);
+
+    private:
+        const std::byte* take(size_t size);
+
+    private:
+        const std::byte* m_payload;
+        size_t m_size;
+        size_t m_offset = 0;
+    };
+
+}
+
+#endif // INC_POLISHD_DEMO_PROTOCOL_HPP
@@ -157,6 +157,7 @@ void REPL::help()
             "\tUse parentheses for subexpressions like `2*(1+2)`.\n"
             "\tPrefix and postfix functions are unary, i.e. take only one parameter,\n"
             "\tSo they could be used with parenthesis like `1 + cos 0`;\n"
+            "\tA selection `COND ? A : B` evaluates to A if COND is not zero and to B otherwise, e.g. `x > 0 ? x : -x`.\n"
             "\tAn argument wrapped in parentheses is treated as a regular subexpression, e.g. sin(pi*0.5).\n"
             "\tAn expression is evaluated from left to right, so `cos 0+1` is equivalent to `(cos 0) + 1`.\n"
             "\n"
@@ -0,0 +1,394 @@
+#include "Server.hpp"
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+    // Ids of the epoll events that are not connections
+    enum : uint64_t
+    {
+        ListenerId = 0,
+        WakeupId,
+        SignalsId,
+        FirstConnectionId
+    };
+
+    // More pipelined requests of a single connection are not read
+    // until some of the pending ones are answered
+    constexpr size_t MaxPendingRequests = 64;
+
+    constexpr int MaxEvents = 64;
+
+    [[noreturn]] void fail(const std::string& what)
+    {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    void watch(int epoll, int fd, uint64_t id, uint32_t events)
+    {
+        epoll_event event {.events = events, .data = {.u64 = id}};
+        if (epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event) == -1)
+            fail("epoll_ctl");
+    }
+
+}
+
+Server::Server(const polishd::Grammar& grammar, std::string socket_path, size_t workers)
+    : m_grammar(grammar), m_socket_path(std::move(socket_path)), m_next_id(FirstConnectionId)
+{
+    sockaddr_un address {.sun_family = AF_UNIX, .sun_path = {}};
+    if (m_socket_path.size() >= sizeof(address.sun_path))
+        throw std::invalid_argument("the socket path is too long");
+    std::memcpy(address.sun_path, m_socket_path.c_str(), m_socket_path.size() + 1);
+
+    m_listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_listener == -1)
+        fail("socket");
+    // a stale socket of a previous run would fail the bind
+    unlink(m_socket_path.c_str());
+    if (bind(m_listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == -1)
+        fail("bind " + m_socket_path);
+    if (listen(m_listener, SOMAXCONN) == -1)
+        fail("listen");
+
+    m_wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wakeup == -1)
+        fail("eventfd");
+
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    // blocked before any worker starts, so the threads inherit the mask
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    m_signals = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (m_signals == -1)
+        fail("signalfd");
+
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epoll == -1)
+        fail("epoll_create1");
+    watch(m_epoll, m_listener, ListenerId, EPOLLIN);
+    watch(m_epoll, m_wakeup, WakeupId, EPOLLIN);
+    watch(m_epoll, m_signals, SignalsId, EPOLLIN);
+
+    m_workers.emplace(workers);
+}
+
+Server::~Server()
+{
+    m_workers.reset();
+    for (const auto& [id, connection]: m_connections)
+        ::close(connection->fd);
+    for (const int fd: {m_epoll, m_signals, m_wakeup, m_listener})
+    {
+        if (fd != -1)
+            ::close(fd);
+    }
+    unlink(m_socket_path.c_str());
+}
+
+void Server::run()
+{
+    epoll_event events[MaxEvents];
+    while (true)
+    {
+        const int count = epoll_wait(m_epoll, events, MaxEvents, -1);
+        if (count == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            fail("epoll_wait");
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            const uint64_t id = events[i].data.u64;
+            if (id == ListenerId)
+                accept();
+            else if (id == WakeupId)
+                complete();
+            else if (id == SignalsId)
+                return;
+            else if (const auto lookup = m_connections.find(id); lookup != m_connections.end())
+            {
+                Connection& connection = *lookup->second;
+                const bool alive = !(events[i].events & (EPOLLERR | EPOLLHUP))
+                    && (!(events[i].events & EPOLLIN) || receive(connection))
+                    && (!(events[i].events & EPOLLOUT) || send(connection));
+                if (alive)
+                    update_events(connection);
+                else
+                    close(id);
+            }
+        }
+    }
+}
+
+void Server::accept()
+{
+    while (true)
+    {
+        const int fd = accept4(m_listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd == -1)
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != ECONNABORTED)
+                std::cerr << "Error: accept: " << std::strerror(errno) << std::endl;
+            return;
+        }
+        auto connection = std::make_unique<Connection>();
+        connection->fd = fd;
+        connection->id = m_next_id++;
+        connection->events = EPOLLIN;
+        watch(m_epoll, fd, connection->id, connection->events);
+        m_connections.emplace(connection->id, std::move(connection));
+    }
+}
+
+bool Server::receive(Connection& connection)
+{
+    while (connection.pending < MaxPendingRequests)
+    {
+        std::byte* destination;
+        size_t remaining;
+        if (connection.header_received < sizeof(protocol::Header))
+        {
+            destination = reinterpret_cast<std::byte*>(&connection.header) + connection.header_received;
+            remaining = sizeof(protocol::Header) - connection.header_received;
+        }
+        else
+        {
+            destination = connection.payload.data() + connection.payload_received;
+            remaining = connection.payload.size() - connection.payload_received;
+        }
+
+        const ssize_t received = read(connection.fd, destination, remaining);
+        if (received == -1)
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        if (received == 0)
+            return false; // closed by the client
+
+        if (connection.header_received < sizeof(protocol::Header))
+        {
+            connection.header_received += received;
+            if (connection.header_received < sizeof(protocol::Header))
+                continue;
+            if (connection.header.size > protocol::MaxMessageSize)
+                return false;
+            // a separate buffer per message keeps the doubles of the payload aligned
+            connection.payload.resize(connection.header.size);
+            connection.payload_received = 0;
+        }
+        else
+            connection.payload_received += received;
+
+        if (connection.payload_received == connection.payload.size())
+            dispatch(connection);
+    }
+    return true;
+}
+
+void Server::dispatch(Connection& connection)
+{
+    ++connection.pending;
+    m_workers->submit([this, id = connection.id, header = connection.header, payload = std::move(connection.payload)]
+    {
+        std::vector<std::byte> response = handle(header, payload);
+        {
+            const std::lock_guard lock(m_completions_mutex);
+            m_completions.push_back({id, std::move(response)});
+        }
+        const uint64_t one = 1;
+        [[maybe_unused]] const ssize_t written = write(m_wakeup, &one, sizeof(one));
+    });
+    connection.header_received = 0;
+    connection.payload = {};
+    connection.payload_received = 0;
+}
+
+void Server::complete()
+{
+    uint64_t count;
+    [[maybe_unused]] const ssize_t received = read(m_wakeup, &count, sizeof(count));
+
+    std::vector<Completion> completions;
+    {
+        const std::lock_guard lock(m_completions_mutex);
+        completions.swap(m_completions);
+    }
+    for (Completion& completion: completions)
+    {
+        // the connection may have been closed in the meantime
+        const auto lookup = m_connections.find(completion.connection);
+        if (lookup == m_connections.end())
+            continue;
+        Connection& connection = *lookup->second;
+        --connection.pending;
+        connection.outbox.push_back(std::move(completion.response));
+        if (send(connection))
+        {
+            // the connection may have unread requests waiting for a free slot
+            if (!receive(connection))
+                close(connection.id);
+            else
+                update_events(connection);
+        }
+        else
+            close(connection.id);
+    }
+}
+
+bool Server::send(Connection& connection)
+{
+    while (!connection.outbox.empty())
+    {
+        const std::vector<std::byte>& message = connection.outbox.front();
+        const ssize_t sent = ::send(connection.fd, message.data() + connection.outbox_sent,
+                                    message.size() - connection.outbox_sent, MSG_NOSIGNAL);
+        if (sent == -1)
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        connection.outbox_sent += sent;
+        if (connection.outbox_sent == message.size())
+        {
+            connection.outbox.pop_front();
+            connection.outbox_sent = 0;
+        }
+    }
+    return true;
+}
+
+void Server::update_events(Connection& connection)
+{
+    uint32_t events = 0;
+    if (connection.pending < MaxPendingRequests)
+        events |= EPOLLIN;
+    if (!connection.outbox.empty())
+        events |= EPOLLOUT;
+    if (events == connection.events)
+        return;
+    epoll_event event {.events = events, .data = {.u64 = connection.id}};
+    if (epoll_ctl(m_epoll, EPOLL_CTL_MOD, connection.fd, &event) == -1)
+        fail("epoll_ctl");
+    connection.events = events;
+}
+
+void Server::close(uint64_t id)
+{
+    const auto lookup = m_connections.find(id);
+    // closing the fd also removes it from the epoll set
+    ::close(lookup->second->fd);
+    m_connections.erase(lookup);
+}
+
+std::vector<std::byte> Server::handle(const protocol::Header& header, const std::vector<std::byte>& payload)
+{
+    const auto request = static_cast<protocol::Request>(header.request);
+    protocol::Reader reader(payload.data(), payload.size());
+    protocol::Writer writer(header.id, request);
+    try
+    {
+        switch (request)
+        {
+            case protocol::Request::Compile:
+                compile(reader, writer);
+                break;
+            case protocol::Request::Evaluate:
+                evaluate(reader, writer);
+                break;
+            case protocol::Request::Delete:
+                remove(reader, writer);
+                break;
+            case protocol::Request::List:
+                list(writer);
+                break;
+            default:
+                throw protocol::Error("unknown request " + std::to_string(header.request));
+        }
+        return std::move(writer).finish();
+    }
+    catch (const std::exception& e)
+    {
+        protocol::Writer error(header.id, request, protocol::Status::Error);
+        error.string(e.what());
+        return std::move(error).finish();
+    }
+}
+
+void Server::compile(protocol::Reader& reader, protocol::Writer& writer)
+{
+    const std::string name(reader.string());
+    const std::string infix(reader.string());
+    polishd::Expected<polishd::Function> f = polishd::try_compile(m_grammar, infix);
+    if (!f)
+        throw protocol::Error(f.error().message(infix));
+
+    auto function = std::make_shared<const polishd::Function>(std::move(f).value());
+    writer.u32(static_cast<uint32_t>(function->arguments().size()));
+    for (const std::string_view arg_name: function->arguments())
+        writer.string(arg_name);
+
+    const std::unique_lock lock(m_functions_mutex);
+    m_functions.insert_or_assign(name, std::move(function));
+}
+
+void Server::evaluate(protocol::Reader& reader, protocol::Writer& writer) const
+{
+    const std::string name(reader.string());
+    const uint32_t rows = reader.u32();
+    const uint32_t columns = reader.u32();
+
+    std::shared_ptr<const polishd::Function> f;
+    {
+        const std::shared_lock lock(m_functions_mutex);
+        const auto lookup = m_functions.find(name);
+        if (lookup == m_functions.end())
+            throw protocol::Error("no function with name '" + name + "'");
+        f = lookup->second;
+    }
+    if (columns != f->arguments().size())
+        throw protocol::Error("the function '" + name + "' takes " + std::to_string(f->arguments().size())
+                              + " arguments, got " + std::to_string(columns) + " columns");
+
+    // the columns are evaluated in place, and the results are written straight into the response
+    const double* const values = reader.doubles(static_cast<size_t>(rows) * columns);
+    polishd::Columns arg_columns;
+    for (size_t i = 0; i < columns; ++i)
+        arg_columns.emplace(f->arguments()[i], values + i * rows);
+    f->evaluate(arg_columns, writer.doubles(rows), rows);
+}
+
+void Server::remove(protocol::Reader& reader, protocol::Writer&)
+{
+    const std::string_view name = reader.string();
+    const std::unique_lock lock(m_functions_mutex);
+    const auto lookup = m_functions.find(std::string(name));
+    if (lookup == m_functions.end())
+        throw protocol::Error("no function with name '" + std::string(name) + "'");
+    m_functions.erase(lookup);
+}
+
+void Server::list(protocol::Writer& writer) const
+{
+    const std::shared_lock lock(m_functions_mutex);
+    writer.u32(static_cast<uint32_t>(m_functions.size()));
+    for (const auto& [name, f]: m_functions)
+    {
+        writer.string(name);
+        writer.string(f->infix());
+        writer.u32(static_cast<uint32_t>(f->arguments().size()));
+        for (const std::string_view arg_name: f->arguments())
+            writer.string(arg_name);
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef INC_POLISHD_DEMO_SERVER_HPP
+#define INC_POLISHD_DEMO_SERVER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <polishd.hpp>
+
+#include "Protocol.hpp"
+#include "WorkerPool.hpp"
+
+// Serves the requests of `Protocol.hpp` on a Unix domain socket.
+// A single thread multiplexes the connections with epoll,
+// while the requests are compiled and evaluated by a pool of workers
+// sharing a single set of saved functions.
+class Server
+{
+public:
+    Server(const polishd::Grammar& grammar, std::string socket_path, size_t workers);
+    ~Server();
+
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    // Serves until SIGINT or SIGTERM
+    void run();
+
+private:
+    struct Connection
+    {
+        int fd = -1;
+        uint64_t id = 0;
+        // The message being received
+        protocol::Header header;
+        size_t header_received = 0;
+        std::vector<std::byte> payload;
+        size_t payload_received = 0;
+        // Requests passed to the workers and not yet answered
+        size_t pending = 0;
+        std::deque<std::vector<std::byte>> outbox;
+        size_t outbox_sent = 0;
+        // Events the fd is currently registered for
+        uint32_t events = 0;
+    };
+
+    struct Completion
+    {
+        uint64_t connection;
+        std::vector<std::byte> response;
+    };
+
+    void accept();
+    // Return false if the connection should be closed
+    bool receive(Connection& connection);
+    bool send(Connection& connection);
+    void dispatch(Connection& connection);
+    void complete();
+    void update_events(Connection& connection);
+    void close(uint64_t id);
+
+    // Run by the workers
+    std::vector<std::byte> handle(const protocol::Header& header, const std::vector<std::byte>& payload);
+    void compile(protocol::Reader& reader, protocol::Writer& writer);
+    void evaluate(protocol::Reader& reader, protocol::Writer& writer) const;
+    void remove(protocol::Reader& reader, protocol::Writer& writer);
+    void list(protocol::Writer& writer) const;
+
+private:
+    const polishd::Grammar& m_grammar;
+    std::string m_socket_path;
+    int m_listener = -1;
+    int m_epoll = -1;
+    // Signaled by the workers when a response is ready
+    int m_wakeup = -1;
+    int m_signals = -1;
+
+    std::unordered_map<uint64_t, std::unique_ptr<Connection>> m_connections;
+    uint64_t m_next_id;
+
+    std::mutex m_completions_mutex;
+    std::vector<Completion> m_completions;
+
+    mutable std::shared_mutex m_functions_mutex;
+    std::unordered_map<std::string, std::shared_ptr<const polishd::Function>> m_functions;
+
+    // Reset first by the destructor, so no worker outlives the state it uses
+    std::optional<WorkerPool> m_workers;
+};
+
+#endif // INC_POLISHD_DEMO_SERVER_HPP
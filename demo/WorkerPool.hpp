@@ -0,0 +1,35 @@
+#ifndef INC_POLISHD_DEMO_WORKER_POOL_HPP
+#define INC_POLISHD_DEMO_WORKER_POOL_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// A fixed number of threads running the submitted tasks in the order of submission.
+// The destructor finishes the queued tasks before joining.
+class WorkerPool
+{
+public:
+    explicit WorkerPool(size_t threads);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+private:
+    void work();
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_ready;
+    std::queue<std::function<void()>> m_tasks;
+    bool m_stopping = false;
+    std::vector<std::thread> m_threads;
+};
+
+#endif // INC_POLISHD_DEMO_WORKER_POOL_HPP
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Client.hpp"
+
+namespace
+{
+
+    void usage()
+    {
+        std::cerr <<
+            "Sends a request to the `polishdd` daemon.\n"
+            "\n"
+            "Usage:\n"
+            "\tpolishd_client [--socket PATH] save NAME EXPR\n"
+            "\tpolishd_client [--socket PATH] evals NAME [NAME=VALUE...]\n"
+            "\tpolishd_client [--socket PATH] delete NAME\n"
+            "\tpolishd_client [--socket PATH] list\n"
+            "\n"
+            "Options:\n"
+            "\t--socket PATH       Unix domain socket of the daemon, /tmp/polishd.sock by default.\n";
+    }
+
+    // Evaluates a single row, the arguments are looked up by their names
+    void evaluate_saved(Client& client, const std::string& name, const std::vector<std::string_view>& args)
+    {
+        const std::vector<Client::Saved> saved = client.list();
+        const auto lookup = std::find_if(saved.begin(), saved.end(), [&](const Client::Saved& f) { return f.name == name; });
+        if (lookup == saved.end())
+            throw std::invalid_argument("no function with name '" + name + "'");
+        const std::vector<std::string>& arguments = lookup->arguments;
+
+        std::vector<double> values(arguments.size());
+        for (size_t i = 0; i < arguments.size(); ++i)
+        {
+            const auto arg = std::find_if(args.begin(), args.end(), [&](std::string_view a)
+            {
+                return a.size() > arguments[i].size() && a.starts_with(arguments[i]) && a[arguments[i].size()] == '=';
+            });
+            if (arg == args.end())
+                throw std::invalid_argument("missing argument: " + arguments[i]);
+            values[i] = std::stod(std::string(arg->substr(arguments[i].size() + 1)));
+        }
+        double result;
+        client.evaluate(name, values.data(), values.size(), 1, &result);
+        std::cout << result << std::endl;
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string_view> args(argv + 1, argv + argc);
+    std::string socket = "/tmp/polishd.sock";
+    if (args.size() >= 2 && args[0] == "--socket")
+    {
+        socket = args[1];
+        args.erase(args.begin(), args.begin() + 2);
+    }
+    if (args.empty())
+    {
+        usage();
+        return 2;
+    }
+
+    try
+    {
+        Client client(socket);
+        const std::string_view command = args[0];
+        if (command == "save" && args.size() >= 3)
+        {
+            std::string infix;
+            for (size_t i = 2; i < args.size(); ++i)
+                infix += std::string(i > 2 ? " " : "") + std::string(args[i]);
+            client.compile(args[1], infix);
+        }
+        else if (command == "evals" && args.size() >= 2)
+            evaluate_saved(client, std::string(args[1]), {args.begin() + 2, args.end()});
+        else if (command == "delete" && args.size() == 2)
+            client.remove(args[1]);
+        else if (command == "list" && args.size() == 1)
+        {
+            for (const Client::Saved& f: client.list())
+                std::cout << f.name << ": " << f.infix << std::endl;
+        }
+        else
+        {
+            usage();
+            return 2;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
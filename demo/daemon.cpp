@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "grammar.hpp"
+#include "Server.hpp"
+
+namespace
+{
+
+    struct Options
+    {
+        std::string socket = "/tmp/polishd.sock";
+        size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    };
+
+    void usage()
+    {
+        std::cerr <<
+            "Compiles and evaluates the expressions of the demo grammar for local clients.\n"
+            "\n"
+            "Usage:\n"
+            "\tpolishdd [--socket PATH] [--workers N]\n"
+            "\n"
+            "Options:\n"
+            "\t--socket PATH       Unix domain socket to listen on, /tmp/polishd.sock by default.\n"
+            "\t--workers N         number of threads compiling and evaluating, one per core by default.\n"
+            "\n"
+            "Stops on SIGINT or SIGTERM. See `Protocol.hpp` for the format of the requests.\n";
+    }
+
+    Options parse_options(int argc, char** argv)
+    {
+        Options options;
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg = argv[i];
+            if (i + 1 == argc)
+                throw std::invalid_argument("missing a value for '" + std::string(arg) + "'");
+            const std::string value = argv[++i];
+            if (arg == "--socket")
+                options.socket = value;
+            else if (arg == "--workers")
+                options.workers = std::max<size_t>(1, std::stoul(value));
+            else
+                throw std::invalid_argument("unexpected option '" + std::string(arg) + "'");
+        }
+        return options;
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    try
+    {
+        options = parse_options(argc, argv);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << "\n\n";
+        usage();
+        return 2;
+    }
+
+    try
+    {
+        polishd::Grammar grammar;
+        setup_demo_grammar(grammar);
+        Server server(grammar, options.socket, options.workers);
+        std::cerr << "Listening on " << options.socket << " with " << options.workers << " workers" << std::endl;
+        server.run();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
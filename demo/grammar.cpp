@@ -0,0 +1,19 @@
+#include "grammar.hpp"
+
+void setup_demo_grammar(polishd::Grammar& grammar)
+{
+    // constants, prefix operators and binary operators
+    grammar = polishd::standard_grammar();
+
+    // postfix operators
+    grammar.add_postfix_operator("!", [](double x) -> double
+    {
+        auto n = (size_t) x;
+        size_t result = 1;
+        while (n > 1)
+        {
+            result *= n--;
+        }
+        return (double) result;
+    });
+}
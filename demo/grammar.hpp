@@ -0,0 +1,8 @@
+#ifndef INC_POLISHD_DEMO_GRAMMAR_HPP
+#define INC_POLISHD_DEMO_GRAMMAR_HPP
+
+#include <polishd.hpp>
+
+void setup_demo_grammar(polishd::Grammar& grammar);
+
+#endif // INC_POLISHD_DEMO_GRAMMAR_HPP
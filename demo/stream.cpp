@@ -0,0 +1,319 @@
+#include <cstdio>
+#include <cstring>
+#include <charconv>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "grammar.hpp"
+#include "MappedFile.hpp"
+
+namespace
+{
+
+    // Rows parsed and evaluated at once.
+    // Bounds the memory used for the parsed columns and the output buffer.
+    constexpr size_t ChunkRows = 1 << 16;
+
+    struct Options
+    {
+        std::string expression;
+        std::string csv;
+        std::vector<std::pair<std::string, std::string>> columns;
+        std::string output;
+        bool text = false;
+    };
+
+    void usage()
+    {
+        std::cerr <<
+            "Streams columns of numbers through a compiled expression.\n"
+            "\n"
+            "Usage:\n"
+            "\tstream EXPR --csv FILE [-o FILE] [--text]\n"
+            "\tstream EXPR --column NAME=FILE... [-o FILE] [--text]\n"
+            "\n"
+            "Options:\n"
+            "\t--csv FILE          comma-separated input; the header row names the arguments.\n"
+            "\t--column NAME=FILE  raw binary column of native doubles for the argument NAME.\n"
+            "\t-o FILE             output file, stdout by default.\n"
+            "\t--text              write the results as text, one per line, instead of raw doubles.\n";
+    }
+
+    Options parse_options(int argc, char** argv)
+    {
+        Options options;
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string_view arg = argv[i];
+            const bool has_value = i + 1 < argc;
+            if (arg == "--csv" && has_value)
+                options.csv = argv[++i];
+            else if (arg == "--column" && has_value)
+            {
+                const std::string_view column = argv[++i];
+                const size_t separator = column.find('=');
+                if (separator == std::string_view::npos || separator == 0)
+                    throw std::invalid_argument("expected NAME=FILE, got '" + std::string(column) + "'");
+                options.columns.emplace_back(column.substr(0, separator), column.substr(separator + 1));
+            }
+            else if (arg == "-o" && has_value)
+                options.output = argv[++i];
+            else if (arg == "--text")
+                options.text = true;
+            else if (options.expression.empty() && !arg.starts_with("-"))
+                options.expression = arg;
+            else
+                throw std::invalid_argument("unexpected option '" + std::string(arg) + "'");
+        }
+        if (options.expression.empty() || options.csv.empty() == options.columns.empty())
+            throw std::invalid_argument("expected an expression and either --csv or --column inputs");
+        return options;
+    }
+
+    class OutputWriter
+    {
+    public:
+        OutputWriter(const std::string& path, bool text) : m_text(text)
+        {
+            m_file = path.empty() ? stdout : std::fopen(path.c_str(), m_text ? "w" : "wb");
+            if (!m_file)
+                throw std::runtime_error("Failed to open '" + path + "' for writing");
+            if (m_text)
+                m_buffer.resize(ChunkRows * MaxTextLength);
+        }
+
+        ~OutputWriter()
+        {
+            if (m_file != stdout)
+                std::fclose(m_file);
+            else
+                std::fflush(m_file);
+        }
+
+        OutputWriter(const OutputWriter&) = delete;
+        OutputWriter& operator=(const OutputWriter&) = delete;
+
+        void write(const double* values, size_t count)
+        {
+            if (!m_text)
+                return put(values, count * sizeof(double));
+
+            for (size_t offset = 0; offset < count; offset += ChunkRows)
+            {
+                const size_t n = std::min(ChunkRows, count - offset);
+                char* end = m_buffer.data();
+                for (size_t i = 0; i < n; ++i)
+                {
+                    end = std::to_chars(end, end + MaxTextLength - 1, values[offset + i]).ptr;
+                    *end++ = '\n';
+                }
+                put(m_buffer.data(), end - m_buffer.data());
+            }
+        }
+
+    private:
+        void put(const void* data, size_t size)
+        {
+            if (std::fwrite(data, 1, size, m_file) != size)
+                throw std::runtime_error("Failed to write the output");
+        }
+
+    private:
+        // The longest shortest round-trip representation of a double is 24 characters
+        static constexpr size_t MaxTextLength = 32;
+
+        std::FILE* m_file = nullptr;
+        bool m_text;
+        std::vector<char> m_buffer;
+    };
+
+    class CsvReader
+    {
+    public:
+        explicit CsvReader(const std::string& path) : m_file(path), m_input(m_file.view())
+        {
+            const std::string_view header = next_line();
+            for (size_t start = 0; start <= header.size();)
+            {
+                size_t end = header.find(',', start);
+                if (end == std::string_view::npos)
+                    end = header.size();
+                m_names.emplace_back(trim(header.substr(start, end - start)));
+                start = end + 1;
+            }
+        }
+
+        [[nodiscard]] const std::vector<std::string>& names() const
+        {
+            return m_names;
+        }
+
+        // Parses up to `ChunkRows` rows into `columns`,
+        // where `columns[i]` receives the i-th field or is skipped if null.
+        // Returns the number of parsed rows.
+        size_t read(const std::vector<double*>& columns)
+        {
+            size_t rows = 0;
+            while (rows < ChunkRows && m_position < m_input.size())
+            {
+                const std::string_view line = next_line();
+                ++m_line;
+                if (trim(line).empty())
+                    continue;
+                const char* it = line.data();
+                const char* const end = line.data() + line.size();
+                for (size_t field = 0; field < columns.size(); ++field)
+                {
+                    if (it > end)
+                        throw std::runtime_error("Too few fields at line " + std::to_string(m_line));
+                    const char* separator = static_cast<const char*>(std::memchr(it, ',', end - it));
+                    if (!separator)
+                        separator = end;
+                    if (columns[field])
+                        columns[field][rows] = parse(it, separator);
+                    it = separator + 1;
+                }
+                ++rows;
+            }
+            m_file.release(m_position);
+            return rows;
+        }
+
+    private:
+        std::string_view next_line()
+        {
+            size_t end = m_input.find('\n', m_position);
+            if (end == std::string_view::npos)
+                end = m_input.size();
+            std::string_view line = m_input.substr(m_position, end - m_position);
+            m_position = end + 1;
+            if (!line.empty() && line.back() == '\r')
+                line.remove_suffix(1);
+            return line;
+        }
+
+        double parse(const char* begin, const char* end) const
+        {
+            while (begin < end && *begin == ' ')
+                ++begin;
+            begin += (begin < end && *begin == '+');
+            double x;
+            const auto [ptr, error] = std::from_chars(begin, end, x);
+            if (error != std::errc() || trim(std::string_view(ptr, end - ptr)).size())
+                throw std::runtime_error("Invalid number '" + std::string(begin, end) + "' at line " + std::to_string(m_line));
+            return x;
+        }
+
+        static std::string_view trim(std::string_view s)
+        {
+            while (!s.empty() && s.front() == ' ')
+                s.remove_prefix(1);
+            while (!s.empty() && s.back() == ' ')
+                s.remove_suffix(1);
+            return s;
+        }
+
+    private:
+        MappedFile m_file;
+        std::string_view m_input;
+        size_t m_position = 0;
+        size_t m_line = 1;
+        std::vector<std::string> m_names;
+    };
+
+    void stream_csv(const polishd::Function& f, const std::string& path, OutputWriter& output)
+    {
+        CsvReader reader(path);
+
+        // only the fields used by the function are parsed
+        std::vector<std::vector<double>> buffers;
+        std::vector<double*> fields(reader.names().size(), nullptr);
+        polishd::Columns columns;
+        buffers.reserve(f.arguments().size());
+        for (const std::string_view name: f.arguments())
+        {
+            size_t field = 0;
+            while (field < fields.size() && reader.names()[field] != name)
+                ++field;
+            if (field == fields.size())
+                throw std::runtime_error("No column for the argument '" + std::string(name) + "'");
+            double* const buffer = buffers.emplace_back(ChunkRows).data();
+            fields[field] = buffer;
+            columns.emplace(name, buffer);
+        }
+
+        std::vector<double> results(ChunkRows);
+        while (const size_t rows = reader.read(fields))
+        {
+            f.evaluate(columns, results.data(), rows);
+            output.write(results.data(), rows);
+        }
+    }
+
+    void stream_columns(const polishd::Function& f,
+                        const std::vector<std::pair<std::string, std::string>>& paths,
+                        OutputWriter& output)
+    {
+        std::vector<std::unique_ptr<MappedFile>> files;
+        polishd::Columns columns;
+        size_t rows = std::string::npos;
+        for (const auto& [name, path]: paths)
+        {
+            const MappedFile& file = *files.emplace_back(std::make_unique<MappedFile>(path));
+            if (file.size() % sizeof(double) != 0)
+                throw std::runtime_error("The size of '" + path + "' is not a multiple of " + std::to_string(sizeof(double)));
+            if (rows != std::string::npos && rows != file.size() / sizeof(double))
+                throw std::runtime_error("The column '" + path + "' has a different number of rows");
+            rows = file.size() / sizeof(double);
+            // the mapping is page aligned, so it can be read as doubles in place
+            columns.insert_or_assign(name, reinterpret_cast<const double*>(file.data()));
+        }
+
+        std::vector<double> results(ChunkRows);
+        polishd::Columns chunk(columns);
+        for (size_t offset = 0; offset < rows; offset += ChunkRows)
+        {
+            const size_t n = std::min(ChunkRows, rows - offset);
+            for (auto& [name, column]: chunk)
+                column = columns.find(name)->second + offset;
+            f.evaluate(chunk, results.data(), n);
+            output.write(results.data(), n);
+            for (const auto& file: files)
+                file->release((offset + n) * sizeof(double));
+        }
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        const Options options = parse_options(argc, argv);
+        polishd::Grammar grammar;
+        setup_demo_grammar(grammar);
+        const polishd::Function f = polishd::compile(grammar, options.expression);
+
+        OutputWriter output(options.output, options.text);
+        if (!options.csv.empty())
+            stream_csv(f, options.csv, output);
+        else
+            stream_columns(f, options.columns, output);
+    }
+    catch (const std::invalid_argument& e)
+    {
+        std::cerr << "Error: " << e.what() << "\n\n";
+        usage();
+        return 2;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
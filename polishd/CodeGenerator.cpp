@@ -0,0 +1,280 @@
+#include <CodeGenerator.hpp>
+
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <limits>
+
+#include <exceptions.hpp>
+
+namespace polishd {
+
+    namespace {
+
+        template<typename T>
+        constexpr std::string_view scalar_name()
+        {
+            if constexpr (std::is_same_v<T, float>)
+                return "float";
+            else if constexpr (std::is_same_v<T, double>)
+                return "double";
+            else
+                return "long double";
+        }
+
+        template<typename T>
+        constexpr std::string_view literal_suffix()
+        {
+            if constexpr (std::is_same_v<T, float>)
+                return "f";
+            else if constexpr (std::is_same_v<T, double>)
+                return "";
+            else
+                return "L";
+        }
+
+    }
+
+    template<typename T>
+    BasicCodeGenerator<T>::BasicCodeGenerator(const Grammar& grammar) : m_grammar(grammar)
+    {
+    }
+
+    template<typename T>
+    void BasicCodeGenerator<T>::add_prefix_code(std::string_view signature, const std::string& code)
+    {
+        const auto lookup = m_grammar.prefix().find(signature);
+        if (lookup == m_grammar.prefix().end())
+            throw CodeGenerationError("no prefix operator '" + std::string(signature) + "' in the grammar");
+        m_unary_indices[lookup->second] = add_code("prefix", signature, scalar_name<T>().data() + std::string(" a"), code);
+    }
+
+    template<typename T>
+    void BasicCodeGenerator<T>::add_postfix_code(std::string_view signature, const std::string& code)
+    {
+        const auto lookup = m_grammar.postfix().find(signature);
+        if (lookup == m_grammar.postfix().end())
+            throw CodeGenerationError("no postfix operator '" + std::string(signature) + "' in the grammar");
+        m_unary_indices[lookup->second] = add_code("postfix", signature, scalar_name<T>().data() + std::string(" a"), code);
+    }
+
+    template<typename T>
+    void BasicCodeGenerator<T>::add_binary_code(std::string_view signature, const std::string& code)
+    {
+        const auto lookup = m_grammar.binary().find(signature);
+        if (lookup == m_grammar.binary().end())
+            throw CodeGenerationError("no binary operator '" + std::string(signature) + "' in the grammar");
+        const std::string scalar(scalar_name<T>());
+        m_binary_indices[lookup->second.binary] = add_code("binary", signature, scalar + " a, " + scalar + " b", code);
+    }
+
+    template<typename T>
+    size_t BasicCodeGenerator<T>::add_code(std::string_view kind, std::string_view signature,
+                                           std::string parameters, const std::string& code)
+    {
+        m_operators.push_back({
+            .signature = std::string(signature),
+            .name = std::string(kind) + "_" + std::to_string(m_operators.size()),
+            .parameters = std::move(parameters),
+            .code = code
+        });
+        return m_operators.size() - 1;
+    }
+
+    template<typename T>
+    void BasicCodeGenerator<T>::add_function(const std::string& name, const Function& f)
+    {
+        if (!is_identifier(name))
+            throw CodeGenerationError("'" + name + "' is not a valid C++ identifier");
+        const Tree tree(f.disassemble());
+        Generated generated {
+            .name = name,
+            .infix = f.infix(),
+            .arguments = {f.arguments().begin(), f.arguments().end()},
+            .body = emit(tree, tree.root())
+        };
+        m_functions.push_back(std::move(generated));
+    }
+
+    template<typename T>
+    std::string BasicCodeGenerator<T>::emit(const Tree& tree, size_t index) const
+    {
+        const auto& node = tree.node(index);
+        const auto child = [&](size_t i) { return emit(tree, node.children[i]); };
+        switch (node.unit.type)
+        {
+            case TokenType::Number:
+                return literal(node.unit.number);
+            case TokenType::Argument:
+                return "args[" + std::to_string(node.unit.arg_index) + "]";
+            case TokenType::Prefix:
+            case TokenType::Postfix:
+                return "operators::" + operator_of(m_unary_indices, node.unit.unary).name + "(" + child(0) + ")";
+            case TokenType::Memoized:
+                // the generated code calls the operator itself
+                return "operators::" + operator_of(m_unary_indices, node.unit.memo->unary()).name + "(" + child(0) + ")";
+            case TokenType::Binary:
+                return "operators::" + operator_of(m_binary_indices, node.unit.binary).name + "(" + child(0) + ", " + child(1) + ")";
+            case TokenType::Stateful:
+                throw CodeGenerationError("stateful operators have no generated code");
+            case TokenType::Power:
+                return "operators::power(" + child(0) + ", " + std::to_string(node.unit.exponent) + ")";
+            case TokenType::MultiplyAdd:
+                return "std::fma(" + child(0) + ", " + child(1) + ", " + child(2) + ")";
+            case TokenType::Select:
+                return "(" + child(0) + " != " + literal(T(0)) + " ? " + child(1) + " : " + child(2) + ")";
+            default:
+                throw UnexpectedUnitError(node.unit.type);
+        }
+    }
+
+    template<typename T>
+    template<typename Op>
+    auto BasicCodeGenerator<T>::operator_of(const std::unordered_map<Op, size_t>& indices, Op op) const -> const Operator&
+    {
+        const auto lookup = indices.find(op);
+        if (lookup != indices.end())
+            return m_operators[lookup->second];
+
+        // name the operator in the message
+        std::string signature;
+        if constexpr (std::is_same_v<Op, typename Grammar::Binary>)
+        {
+            for (const auto& [s, binary]: m_grammar.binary())
+                signature = binary.binary == op ? s : signature;
+        }
+        else
+        {
+            for (const auto* ops: {&m_grammar.prefix(), &m_grammar.postfix()})
+                for (const auto& [s, unary]: *ops)
+                    signature = unary == op ? s : signature;
+        }
+        throw CodeGenerationError("no code for the operator '" + signature + "'");
+    }
+
+    template<typename T>
+    void BasicCodeGenerator<T>::write(std::ostream& out, std::string_view name_space) const
+    {
+        if (m_functions.empty())
+            throw CodeGenerationError("no functions to write");
+
+        const std::string_view scalar = scalar_name<T>();
+        out << "// Generated by polishd, do not edit.\n"
+               "#pragma once\n"
+               "\n"
+               "#include <cmath>\n"
+               "#include <limits>\n"
+               "#include <string_view>\n"
+               "\n"
+               "#include <NativeFunction.hpp>\n"
+               "\n"
+               "namespace " << name_space << " {\n"
+               "\n"
+               "    namespace operators {\n"
+               "\n";
+        for (const Operator& op: m_operators)
+        {
+            out << "        // " << op.signature << "\n"
+                   "        inline " << scalar << " " << op.name << "(" << op.parameters << ")\n"
+                   "        {\n"
+                   "            return " << op.code << ";\n"
+                   "        }\n"
+                   "\n";
+        }
+        out << "        inline " << scalar << " power(" << scalar << " x, int n)\n"
+               "        {\n"
+               "            unsigned exponent = n < 0 ? -static_cast<unsigned>(n) : static_cast<unsigned>(n);\n"
+               "            " << scalar << " result = " << literal(T(1)) << ";\n"
+               "            for (; exponent; exponent >>= 1, x *= x)\n"
+               "            {\n"
+               "                if (exponent & 1u)\n"
+               "                    result *= x;\n"
+               "            }\n"
+               "            return n < 0 ? " << literal(T(1)) << " / result : result;\n"
+               "        }\n"
+               "\n"
+               "    } // namespace operators\n"
+               "\n";
+
+        for (const Generated& f: m_functions)
+        {
+            out << "    // " << f.infix << "\n"
+                   "    inline " << scalar << " " << f.name << "([[maybe_unused]] const " << scalar << "* args)\n"
+                   "    {\n"
+                   "        return " << f.body << ";\n"
+                   "    }\n"
+                   "\n";
+            if (f.arguments.empty())
+                continue;
+            out << "    inline constexpr std::string_view " << f.name << "_arguments[] {";
+            for (size_t i = 0; i < f.arguments.size(); ++i)
+                out << (i ? ", " : "") << quote(f.arguments[i]);
+            out << "};\n"
+                   "\n";
+        }
+
+        out << "    inline constexpr polishd::BasicNativeFunction<" << scalar << "> functions[] {\n";
+        for (const Generated& f: m_functions)
+        {
+            out << "        {" << quote(f.name) << ", " << quote(f.infix) << ", " << f.name << ", ";
+            if (f.arguments.empty())
+                out << "{}";
+            else
+                out << f.name << "_arguments";
+            out << "},\n";
+        }
+        out << "    };\n"
+               "\n"
+               "} // namespace " << name_space << "\n";
+    }
+
+    template<typename T>
+    std::string BasicCodeGenerator<T>::literal(T value)
+    {
+        const std::string scalar(scalar_name<T>());
+        if (std::isnan(value))
+            return "std::numeric_limits<" + scalar + ">::quiet_NaN()";
+        if (std::isinf(value))
+            return std::string(value < 0 ? "-" : "") + "std::numeric_limits<" + scalar + ">::infinity()";
+
+        // the shortest representation that reads back to the same value
+        char buffer[64];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        std::string s(buffer, result.ptr);
+        if (s.find_first_of(".e") == std::string::npos)
+            s += ".0";
+        s += literal_suffix<T>();
+        return value < 0 ? "(" + s + ")" : s;
+    }
+
+    template<typename T>
+    std::string BasicCodeGenerator<T>::quote(std::string_view s)
+    {
+        std::string quoted = "\"";
+        for (const char c: s)
+        {
+            if (c == '"' || c == '\\')
+                quoted += '\\';
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+
+    template<typename T>
+    bool BasicCodeGenerator<T>::is_identifier(std::string_view s)
+    {
+        if (s.empty() || std::isdigit(static_cast<unsigned char>(s[0])))
+            return false;
+        for (const char c: s)
+        {
+            if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_')
+                return false;
+        }
+        return true;
+    }
+
+    template class BasicCodeGenerator<float>;
+    template class BasicCodeGenerator<double>;
+    template class BasicCodeGenerator<long double>;
+
+} // namespace polishd
@@ -0,0 +1,90 @@
+#ifndef INC_POLISHD_CODE_GENERATOR_HPP
+#define INC_POLISHD_CODE_GENERATOR_HPP
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <Grammar.hpp>
+#include <Function.hpp>
+#include <ExpressionTree.hpp>
+
+namespace polishd {
+
+    // Writes compiled functions as C++ code, one plain inline function per expression,
+    // so that the C++ compiler can inline and vectorize across the whole expression.
+    // The operators of the `Grammar` are only known as function pointers,
+    // so each operator used by the functions needs its code to be added first.
+    template<typename T>
+    class BasicCodeGenerator
+    {
+    public:
+        using Grammar = BasicGrammar<T>;
+        using Function = BasicFunction<T>;
+
+        explicit BasicCodeGenerator(const Grammar& grammar);
+
+        // `code` is a C++ expression of the operand `a`, e.g. `std::sin(a)`
+        void add_prefix_code(std::string_view signature, const std::string& code);
+        void add_postfix_code(std::string_view signature, const std::string& code);
+        // `code` is a C++ expression of the operands `a` and `b`, e.g. `a + b`
+        void add_binary_code(std::string_view signature, const std::string& code);
+
+        // Generates `inline T name(const T* args)`
+        // taking the argument values in the order of `f.arguments()`.
+        // Throws `CodeGenerationError` if an operator of `f` has no code.
+        void add_function(const std::string& name, const Function& f);
+
+        // Writes a self-contained header with the functions in the namespace `name_space`
+        // and a `functions` table of `BasicNativeFunction`s for `BasicRegistry`
+        void write(std::ostream& out, std::string_view name_space) const;
+
+    private:
+        using Tree = BasicExpressionTree<T>;
+
+        struct Operator
+        {
+            std::string signature;
+            std::string name;
+            std::string parameters;
+            std::string code;
+        };
+
+        struct Generated
+        {
+            std::string name;
+            std::string infix;
+            std::vector<std::string> arguments;
+            std::string body;
+        };
+
+        // Returns the index of the added operator
+        size_t add_code(std::string_view kind, std::string_view signature, std::string parameters, const std::string& code);
+        std::string emit(const Tree& tree, size_t index) const;
+        template<typename Op>
+        const Operator& operator_of(const std::unordered_map<Op, size_t>& indices, Op op) const;
+
+        static std::string literal(T value);
+        static std::string quote(std::string_view s);
+        static bool is_identifier(std::string_view s);
+
+    private:
+        const Grammar& m_grammar;
+        // Indices into `m_operators` by the operator's function
+        std::unordered_map<typename Grammar::Unary, size_t> m_unary_indices;
+        std::unordered_map<typename Grammar::Binary, size_t> m_binary_indices;
+        std::vector<Operator> m_operators;
+        std::vector<Generated> m_functions;
+    };
+
+    extern template class BasicCodeGenerator<float>;
+    extern template class BasicCodeGenerator<double>;
+    extern template class BasicCodeGenerator<long double>;
+
+    using CodeGenerator = BasicCodeGenerator<double>;
+
+} // namespace polishd
+
+#endif // INC_POLISHD_CODE_GENERATOR_HPP
@@ -0,0 +1,23 @@
+#ifndef INC_POLISHD_COMPILE_OPTIONS_HPP
+#define INC_POLISHD_COMPILE_OPTIONS_HPP
+
+namespace polishd {
+
+    struct CompileOptions
+    {
+        // Disables the rewrites that may change the rounding of the results:
+        // small integer powers as multiplications, polynomials in Horner's scheme
+        // and `a * b + c` as a fused multiply-add.
+        // The rewrites only ever apply to the operators marked with `Arithmetic` in the `Grammar`.
+        // The batch evaluation only fuses the multiply-adds on CPUs with the instructions for them,
+        // and otherwise rounds the products like a strict function.
+        bool strict_ieee = false;
+        // Lifts the literals out of the program into the function, so that the functions of the same shape,
+        // e.g. `2 * x + 1` and `3 * x + 5`, share a single program, see `Function::evaluate_each`.
+        // The literals rewritten by the compiler stay in the shape, e.g. the exponent of `x ^ 2`.
+        bool share_programs = false;
+    };
+
+} // namespace polishd
+
+#endif // INC_POLISHD_COMPILE_OPTIONS_HPP
@@ -4,28 +4,77 @@
 #include <stack>
 #include <sstream>
 #include <charconv>
+#include <chrono>
+#include <iterator>
 
 #include <exceptions.hpp>
+#include <Instrumentation.hpp>
+#include <Optimizer.hpp>
 
 namespace polishd {
 
-    CompilingContext::CompilingContext(const Grammar& grammar, const std::string& infix) : m_grammar(grammar), m_infix(infix) 
+    template<typename T>
+    BasicCompilingContext<T>::BasicCompilingContext(const Grammar& grammar, const std::string& infix, const CompileOptions& options)
+        : m_grammar(grammar), m_infix(infix), m_options(options)
     {
     }
 
-    Function CompilingContext::compile()
+    template<typename T>
+    auto BasicCompilingContext<T>::compile() -> Function
     {
-        TokenList tokens = tokenize();
-        const size_t size = convert_infix_to_postfix(tokens);
+        Expected<Function> f = try_compile();
+        if (!f)
+            f.error().raise(m_infix);
+        return std::move(f).value();
+    }
+
+    template<typename T>
+    auto BasicCompilingContext<T>::try_compile() -> Expected<Function>
+    {
+        if (!instrumentation::enabled()) [[likely]]
+            return try_compile(nullptr);
+        instrumentation::CompileStats stats {.compilations = 1};
+        Expected<Function> f = try_compile(&stats);
+        stats.failures = f ? 0 : 1;
+        instrumentation::record(stats);
+        return f;
+    }
+
+    template<typename T>
+    auto BasicCompilingContext<T>::try_compile(instrumentation::CompileStats* stats) -> Expected<Function>
+    {
+        const auto timed = [](std::chrono::nanoseconds* total, auto&& phase)
+        {
+            const instrumentation::ScopedTimer timer(total);
+            return phase();
+        };
+        Expected<TokenList> tokens = timed(stats ? &stats->tokenize : nullptr, [&] { return tokenize(); });
+        if (!tokens)
+            return tokens.error();
+        if (stats) [[unlikely]]
+            stats->tokens = std::distance(tokens->begin(), tokens->end());
+        const Expected<size_t> size = timed(stats ? &stats->shunting_yard : nullptr, [&] { return convert_infix_to_postfix(*tokens); });
+        if (!size)
+            return size.error();
+        const instrumentation::ScopedTimer codegen(stats ? &stats->codegen : nullptr);
+        // compiled first, as it collects the stateful operators
+        typename Function::Expression expression = compile_optimized(*tokens, *size);
+        if (stats) [[unlikely]]
+            stats->units = expression.size();
+        if (expression.size() > Function::MaxUnits)
+            return make_error(ErrorCode::ExpressionTooLong, 0);
         return Function(
-            compile(tokens, size),
+            std::move(expression),
             m_arg_indices,
             m_infix,
-            stringify(tokens)
+            stringify(*tokens),
+            std::move(m_stateful),
+            m_options.share_programs
         );
     }
 
-    CompilingContext::TokenList CompilingContext::tokenize() const
+    template<typename T>
+    auto BasicCompilingContext<T>::tokenize() const -> Expected<TokenList>
     {
         size_t start = 0;
         TokenList tokens;
@@ -37,25 +86,32 @@ namespace polishd {
         
         while (start < m_infix.size())
         {
-            last = tokens.insert_after(last, 
-                expectOperand
+            const Token token = expectOperand
                 ? parse_operand(start)
-                : parse_operator(start));
+                : parse_operator(start);
+            if (token.type == TokenType::None)
+                return make_error(expectOperand ? ErrorCode::ExpectedOperand : ErrorCode::ExpectedOperator, start);
+            last = tokens.insert_after(last, token);
             
             start += last->value.size();
             
             if(last->type == TokenType::Number || last->type == TokenType::Argument)
                 expectOperand = false;
-            else if(last->type == TokenType::Binary)
+            else if(last->type == TokenType::Binary || last->type == TokenType::Condition || last->type == TokenType::Alternative)
                 expectOperand = true;
 
             while (start < m_infix.size() && m_infix[start] == ' ')
                 ++start;
         }
+        if (tokens.empty())
+            return make_error(ErrorCode::EmptyExpression, 0);
+        if (expectOperand)
+            return make_error(ErrorCode::UnexpectedEnd, m_infix.size());
         return tokens;
     }
 
-    Token CompilingContext::parse_operand(size_t start) const
+    template<typename T>
+    Token BasicCompilingContext<T>::parse_operand(size_t start) const
     {
         auto type = TokenType::None;
         size_t length;
@@ -68,12 +124,13 @@ namespace polishd {
         else if((length = Grammar::match_argument(m_infix, start)))
             type = TokenType::Argument;
         else
-            throw ExpressionSyntaxError("expected a number, an argument, a prefix function or an opening parenthesis starting at " + m_infix.substr(start));
+            length = 0;
         
         return Token{.type = type, .value = std::string_view(m_infix).substr(start, length)};
     }
 
-    Token CompilingContext::parse_operator(size_t start) const
+    template<typename T>
+    Token BasicCompilingContext<T>::parse_operator(size_t start) const
     {
         auto type = TokenType::None;
         size_t length;
@@ -83,17 +140,31 @@ namespace polishd {
             type = TokenType::Postfix;
         else if ((length = (m_infix[start] == ')')))
             type = TokenType::Closing;
+        else if ((length = (m_infix[start] == '?')))
+            type = TokenType::Condition;
+        else if ((length = (m_infix[start] == ':')))
+            type = TokenType::Alternative;
         else
-            throw ExpressionSyntaxError("expected a binary operator, a postfix function or a closing parenthesis starting at " + m_infix.substr(start));
+            length = 0;
 
         return Token{.type = type, .value = std::string_view(m_infix).substr(start, length)};
     }
 
-    size_t CompilingContext::convert_infix_to_postfix(TokenList& infix) const
+    template<typename T>
+    auto BasicCompilingContext<T>::convert_infix_to_postfix(TokenList& infix) const -> Expected<size_t>
     {
         std::stack<Token> stack;
         size_t size = 0;
         auto prev = infix.before_begin();
+        // move the top token from stack to list
+        const auto pop = [&]()
+        {
+            // the alternative on the stack marks a selection that ends here
+            const Token top = stack.top().type == TokenType::Alternative ? select_token() : stack.top();
+            prev = infix.insert_after(prev, top);
+            ++size;
+            stack.pop();
+        };
         for(auto it = infix.begin(); it != infix.end();)
         {
             switch(it->type)
@@ -112,28 +183,63 @@ namespace polishd {
                     // then move current from list to stack
                     Token binary(*it);
                     infix.erase_after(prev);
-                    const Grammar::Precedence p = m_grammar.precedence_of(binary.value);
-                    while(!stack.empty() && (stack.top().type == TokenType::Prefix || m_grammar.precedence_of(stack.top().value) > p))
-                    {
-                        prev = infix.insert_after(prev, stack.top());
-                        ++size;
-                        stack.pop();
-                    }
+                    const typename Grammar::Precedence p = m_grammar.precedence_of(binary.value);
+                    while(!stack.empty() && (stack.top().type == TokenType::Prefix || (stack.top().type == TokenType::Binary && m_grammar.precedence_of(stack.top().value) > p)))
+                        pop();
                     it = prev;
                     ++it;
                     stack.push(binary);
                     break;
                 }
 
+                case TokenType::Condition:
+                {
+                    // the selection has the lowest precedence,
+                    // so move from stack to list all prefix and binary tokens of the condition;
+                    // then keep current in the list and mark it on the stack
+                    Token condition(*it);
+                    infix.erase_after(prev);
+                    while(!stack.empty() && (stack.top().type == TokenType::Prefix || stack.top().type == TokenType::Binary))
+                        pop();
+                    prev = infix.insert_after(prev, condition);
+                    ++size;
+                    it = prev;
+                    ++it;
+                    stack.push(condition);
+                    break;
+                }
+
+                case TokenType::Alternative:
+                {
+                    // move from stack to list everything up to the matching condition;
+                    // then replace the condition mark on the stack with current and keep it in the list
+                    Token alternative(*it);
+                    infix.erase_after(prev);
+                    while(!stack.empty() && stack.top().type != TokenType::Condition && stack.top().type != TokenType::Opening)
+                        pop();
+                    if (stack.empty() || stack.top().type != TokenType::Condition)
+                        return make_error(ErrorCode::UnmatchedAlternative, alternative);
+                    stack.pop();
+                    prev = infix.insert_after(prev, alternative);
+                    ++size;
+                    it = prev;
+                    ++it;
+                    stack.push(alternative);
+                    break;
+                }
+
                 case TokenType::Closing:
                 {
+                    const Token closing(*it);
                     infix.erase_after(prev);
-                    while(stack.top().type != TokenType::Opening)
+                    while(!stack.empty() && stack.top().type != TokenType::Opening)
                     {
-                        prev = infix.insert_after(prev, stack.top());
-                        ++size;
-                        stack.pop();
+                        if (stack.top().type == TokenType::Condition)
+                            return make_error(ErrorCode::MissingAlternative, stack.top());
+                        pop();
                     }
+                    if (stack.empty())
+                        return make_error(ErrorCode::UnmatchedClosing, closing);
                     it = prev;
                     ++it;
                     stack.pop(); // pop Opening token from stack
@@ -150,23 +256,62 @@ namespace polishd {
         }
         while(!stack.empty())
         {
-            prev = infix.insert_after(prev, stack.top());
-            ++size;
-            stack.pop();
+            if (stack.top().type == TokenType::Opening)
+                return make_error(ErrorCode::UnmatchedOpening, stack.top());
+            if (stack.top().type == TokenType::Condition)
+                return make_error(ErrorCode::MissingAlternative, stack.top());
+            pop();
         }
         return size;
     }
 
-    Function::Expression CompilingContext::compile(const TokenList& postfix, size_t size)
+    template<typename T>
+    auto BasicCompilingContext<T>::compile(const TokenList& postfix, size_t size) -> typename Function::Expression
     {
-        Function::Expression expression;
+        typename Function::Expression expression;
         expression.reserve(size);
+        // indices of the conditions and the alternatives waiting for their jump targets
+        std::stack<size_t> selections;
         for (const Token& token: postfix)
-            expression.push_back(compile(token));
+        {
+            switch (token.type)
+            {
+                case TokenType::Condition:
+                    selections.push(expression.size());
+                    expression.push_back({.type = token.type, .jump = 0});
+                    break;
+                case TokenType::Alternative:
+                    // a false condition continues right after the alternative
+                    expression[selections.top()].jump = expression.size() + 1;
+                    selections.pop();
+                    selections.push(expression.size());
+                    expression.push_back({.type = token.type, .jump = 0});
+                    break;
+                case TokenType::Select:
+                    // the end of the consequent skips the alternative
+                    expression[selections.top()].jump = expression.size() + 1;
+                    selections.pop();
+                    expression.push_back({.type = token.type, .jump = 0});
+                    break;
+                default:
+                    expression.push_back(compile(token));
+                    break;
+            }
+        }
+        return expression;
+    }
+
+    template<typename T>
+    auto BasicCompilingContext<T>::compile_optimized(const TokenList& postfix, size_t size) -> typename Function::Expression
+    {
+        typename Function::Expression expression = compile(postfix, size);
+        if (!m_options.strict_ieee)
+            BasicOptimizer<T>(m_grammar).optimize(expression);
         return expression;
     }
 
-    Function::Unit CompilingContext::compile(const Token& token)
+    template<typename T>
+    auto BasicCompilingContext<T>::compile(const Token& token) -> typename Function::Unit
     {
         switch (token.type)
         {
@@ -185,14 +330,16 @@ namespace polishd {
         }
     }
 
-    Function::Unit CompilingContext::compile_number(const Token& token)
+    template<typename T>
+    auto BasicCompilingContext<T>::compile_number(const Token& token) -> typename Function::Unit
     {
-        double x;
+        T x;
         std::from_chars(token.value.data(), token.value.data() + token.value.size(), x);
         return {.type = token.type, .number = x};
     }
 
-    Function::Unit CompilingContext::compile_argument(const Token& token)
+    template<typename T>
+    auto BasicCompilingContext<T>::compile_argument(const Token& token) -> typename Function::Unit
     {
         if (const auto const_lookup = m_grammar.constants().find(token.value); const_lookup != m_grammar.constants().end())
         {
@@ -208,29 +355,45 @@ namespace polishd {
         return {.type = token.type, .arg_index = m_arg_indices.size()-1};
     }
     
-    Function::Unit CompilingContext::compile_prefix(const Token& token) const
+    template<typename T>
+    auto BasicCompilingContext<T>::compile_prefix(const Token& token) -> typename Function::Unit
     {
-        return compile_unary(token, m_grammar.prefix());
+        if (const auto memoized = m_grammar.memoized().find(token.value); memoized != m_grammar.memoized().end())
+            return {.type = TokenType::Memoized, .memo = memoized->second.get()};
+        if (m_grammar.prefix().contains(token.value))
+            return compile_unary(token, m_grammar.prefix());
+        m_stateful.push_back(m_grammar.stateful().find(token.value)->second);
+        return {.type = TokenType::Stateful, .stateful = m_stateful.size() - 1};
     }
     
-    Function::Unit CompilingContext::compile_postfix(const Token& token) const
+    template<typename T>
+    auto BasicCompilingContext<T>::compile_postfix(const Token& token) const -> typename Function::Unit
     {
         return compile_unary(token, m_grammar.postfix());
     }
     
-    Function::Unit CompilingContext::compile_unary(const Token& token, const TransparentStringKeyMap<Grammar::Unary>& ops)
+    template<typename T>
+    auto BasicCompilingContext<T>::compile_unary(const Token& token, const TransparentStringKeyMap<typename Grammar::Unary>& ops) -> typename Function::Unit
     {
-        const Grammar::Unary unary = ops.find(token.value)->second;
+        const typename Grammar::Unary unary = ops.find(token.value)->second;
         return {.type = token.type, .unary = unary};
     }
 
-    Function::Unit CompilingContext::compile_binary(const Token& token) const
+    template<typename T>
+    auto BasicCompilingContext<T>::compile_binary(const Token& token) const -> typename Function::Unit
     {
-        const Grammar::Binary binary = m_grammar.binary().find(token.value)->second.binary;
+        const typename Grammar::Binary binary = m_grammar.binary().find(token.value)->second.binary;
         return {.type = token.type, .binary = binary};
     }
 
-    std::string CompilingContext::stringify(const TokenList& tokens)
+    template<typename T>
+    Token BasicCompilingContext<T>::select_token()
+    {
+        return Token{.type = TokenType::Select, .value = "?:"};
+    }
+
+    template<typename T>
+    std::string BasicCompilingContext<T>::stringify(const TokenList& tokens)
     {
         std::stringstream stream;
         for(const Token& token : tokens)
@@ -238,4 +401,24 @@ namespace polishd {
         return stream.str();
     }
 
+    template<typename T>
+    Error BasicCompilingContext<T>::make_error(ErrorCode code, size_t offset) const
+    {
+        return {.code = code, .offset = static_cast<uint32_t>(offset)};
+    }
+
+    template<typename T>
+    Error BasicCompilingContext<T>::make_error(ErrorCode code, const Token& token) const
+    {
+        return {
+            .code = code,
+            .offset = static_cast<uint32_t>(token.value.data() - m_infix.data()),
+            .length = static_cast<uint32_t>(token.value.size())
+        };
+    }
+
+    template class BasicCompilingContext<float>;
+    template class BasicCompilingContext<double>;
+    template class BasicCompilingContext<long double>;
+
 } // namespace polishd
@@ -5,46 +5,72 @@
 #include <string_view>
 #include <forward_list>
 #include <unordered_map>
+#include <vector>
 
 #include <Token.hpp>
 #include <Grammar.hpp>
 #include <Function.hpp>
+#include <Expected.hpp>
+#include <CompileOptions.hpp>
 
 namespace polishd {
 
-    class CompilingContext
+    template<typename T>
+    class BasicCompilingContext
     {
     public:
-        explicit CompilingContext(const Grammar& grammar, const std::string& infix);
+        using Grammar = BasicGrammar<T>;
+        using Function = BasicFunction<T>;
+
+        explicit BasicCompilingContext(const Grammar& grammar, const std::string& infix, const CompileOptions& options = {});
         
         Function compile();
+        Expected<Function> try_compile();
 
     private:
         using TokenList = std::forward_list<Token>;
 
-        TokenList tokenize() const;
+        // The phases of `try_compile`, timed into `stats` unless it is null, i.e. the instrumentation is disabled
+        Expected<Function> try_compile(instrumentation::CompileStats* stats);
+
+        Expected<TokenList> tokenize() const;
+        // Return a token of type `TokenType::None` if nothing matches
         Token parse_operand(size_t start) const;
         Token parse_operator(size_t start) const;
 
-        size_t convert_infix_to_postfix(TokenList& infix) const;
+        Expected<size_t> convert_infix_to_postfix(TokenList& infix) const;
         
-        Function::Expression compile(const TokenList& postfix, size_t size);
-        Function::Unit compile(const Token& token);
+        typename Function::Expression compile(const TokenList& postfix, size_t size);
+        // Compiles the units and applies the rewrites allowed by the options
+        typename Function::Expression compile_optimized(const TokenList& postfix, size_t size);
+        typename Function::Unit compile(const Token& token);
 
-        static Function::Unit compile_number(const Token& token);
-        Function::Unit compile_argument(const Token& token);
-        Function::Unit compile_prefix(const Token& token) const;
-        Function::Unit compile_postfix(const Token& token) const;
-        static Function::Unit compile_unary(const Token& token, const TransparentStringKeyMap<Grammar::Unary>& ops);
-        Function::Unit compile_binary(const Token& token) const;
+        static typename Function::Unit compile_number(const Token& token);
+        typename Function::Unit compile_argument(const Token& token);
+        typename Function::Unit compile_prefix(const Token& token);
+        typename Function::Unit compile_postfix(const Token& token) const;
+        static typename Function::Unit compile_unary(const Token& token, const TransparentStringKeyMap<typename Grammar::Unary>& ops);
+        typename Function::Unit compile_binary(const Token& token) const;
 
+        static Token select_token();
         static std::string stringify(const TokenList& tokens);
+        Error make_error(ErrorCode code, size_t offset) const;
+        Error make_error(ErrorCode code, const Token& token) const;
     private:
         const Grammar& m_grammar;
         const std::string& m_infix;
+        CompileOptions m_options;
         std::unordered_map<std::string_view, size_t> m_arg_indices;
+        // The stateful operators in the order of their occurrence
+        std::vector<typename Grammar::Stateful> m_stateful;
     };
 
+    extern template class BasicCompilingContext<float>;
+    extern template class BasicCompilingContext<double>;
+    extern template class BasicCompilingContext<long double>;
+
+    using CompilingContext = BasicCompilingContext<double>;
+
 } // namespace polishd
 
 #endif //INC_POLISHD_COMPILER_HPP
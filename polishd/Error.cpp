@@ -0,0 +1,70 @@
+#include <Error.hpp>
+
+#include <algorithm>
+
+#include <exceptions.hpp>
+
+namespace polishd {
+
+    namespace
+    {
+
+        std::string describe_syntax_error(const Error& error, std::string_view infix)
+        {
+            const std::string_view tail = infix.substr(std::min<size_t>(error.offset, infix.size()));
+            switch (error.code)
+            {
+                case ErrorCode::EmptyExpression:
+                    return "the expression is empty";
+                case ErrorCode::ExpectedOperand:
+                    return "expected a number, an argument, a prefix function or an opening parenthesis starting at " + std::string(tail);
+                case ErrorCode::ExpectedOperator:
+                    return "expected a binary operator, a postfix function or a closing parenthesis starting at " + std::string(tail);
+                case ErrorCode::UnexpectedEnd:
+                    return "expected a number, an argument, a prefix function or an opening parenthesis at the end";
+                case ErrorCode::UnmatchedOpening:
+                    return "unmatched opening parenthesis starting at " + std::string(tail);
+                case ErrorCode::UnmatchedClosing:
+                    return "unmatched closing parenthesis starting at " + std::string(tail);
+                case ErrorCode::MissingAlternative:
+                    return "expected ':' for the condition starting at " + std::string(tail);
+                case ErrorCode::UnmatchedAlternative:
+                    return "':' without a preceding '?' starting at " + std::string(tail);
+                case ErrorCode::ExpressionTooLong:
+                    return "the expression is too long";
+                default:
+                    return "unknown error";
+            }
+        }
+
+        std::string argument_name(const Error& error, std::string_view infix)
+        {
+            return std::string(infix.substr(std::min<size_t>(error.offset, infix.size()), error.length));
+        }
+
+    }
+
+    Error::operator bool() const
+    {
+        return code != ErrorCode::None;
+    }
+
+    std::string Error::message(std::string_view infix) const
+    {
+        if (code == ErrorCode::MissingArgument)
+            return MissingArgumentError(argument_name(*this, infix)).what();
+        if (code == ErrorCode::StatefulFunction)
+            return StatefulFunctionError().what();
+        return ExpressionSyntaxError(describe_syntax_error(*this, infix)).what();
+    }
+
+    void Error::raise(std::string_view infix) const
+    {
+        if (code == ErrorCode::MissingArgument)
+            throw MissingArgumentError(argument_name(*this, infix));
+        if (code == ErrorCode::StatefulFunction)
+            throw StatefulFunctionError();
+        throw ExpressionSyntaxError(describe_syntax_error(*this, infix));
+    }
+
+} // namespace polishd
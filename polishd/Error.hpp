@@ -0,0 +1,52 @@
+#ifndef INC_POLISHD_ERROR_HPP
+#define INC_POLISHD_ERROR_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace polishd {
+
+    enum class ErrorCode : unsigned char
+    {
+        None = 0,
+        EmptyExpression,
+        ExpectedOperand,
+        ExpectedOperator,
+        UnexpectedEnd,
+        UnmatchedOpening,
+        UnmatchedClosing,
+        MissingAlternative,
+        UnmatchedAlternative,
+        MissingArgument,
+        // The expression compiles to more units than a function can address
+        ExpressionTooLong,
+        // A function with stateful operators is evaluated without a `BasicStreamEvaluator`
+        StatefulFunction
+    };
+
+    // A compact description of a failure.
+    // No message is built until `message()` is called,
+    // so failing is as cheap as returning an integer.
+    struct Error
+    {
+        ErrorCode code = ErrorCode::None;
+        // Position in the infix expression the error refers to.
+        // For `MissingArgument` it is the first occurrence of the missing argument.
+        uint32_t offset = 0;
+        // Length of the offending part of the expression, if known
+        uint32_t length = 0;
+
+        explicit operator bool() const;
+
+        // Formats the same message as the exception thrown by the throwing API.
+        // `infix` must be the expression the error was produced for.
+        [[nodiscard]] std::string message(std::string_view infix) const;
+
+        // Throws the exception corresponding to the error
+        [[noreturn]] void raise(std::string_view infix) const;
+    };
+
+} // namespace polishd
+
+#endif // INC_POLISHD_ERROR_HPP
@@ -0,0 +1,56 @@
+#ifndef INC_POLISHD_EXPECTED_HPP
+#define INC_POLISHD_EXPECTED_HPP
+
+#include <utility>
+#include <variant>
+
+#include <Error.hpp>
+
+namespace polishd {
+
+    // A minimal `std::expected`-like holder of either a value or an `Error`
+    template<typename T>
+    class Expected
+    {
+    public:
+        Expected(T value) : m_storage(std::in_place_index<0>, std::move(value)) {}
+        Expected(Error error) : m_storage(std::in_place_index<1>, error) {}
+
+        [[nodiscard]] bool has_value() const { return m_storage.index() == 0; }
+        explicit operator bool() const { return has_value(); }
+
+        [[nodiscard]] const T& value() const& { return std::get<0>(m_storage); }
+        [[nodiscard]] T& value() & { return std::get<0>(m_storage); }
+        [[nodiscard]] T&& value() && { return std::get<0>(std::move(m_storage)); }
+
+        const T& operator*() const& { return value(); }
+        T& operator*() & { return value(); }
+        T&& operator*() && { return std::move(*this).value(); }
+        const T* operator->() const { return &value(); }
+        T* operator->() { return &value(); }
+
+        [[nodiscard]] const Error& error() const { return std::get<1>(m_storage); }
+
+    private:
+        std::variant<T, Error> m_storage;
+    };
+
+    template<>
+    class Expected<void>
+    {
+    public:
+        Expected() = default;
+        Expected(Error error) : m_error(error) {}
+
+        [[nodiscard]] bool has_value() const { return !m_error; }
+        explicit operator bool() const { return has_value(); }
+
+        [[nodiscard]] const Error& error() const { return m_error; }
+
+    private:
+        Error m_error;
+    };
+
+} // namespace polishd
+
+#endif // INC_POLISHD_EXPECTED_HPP
@@ -0,0 +1,135 @@
+#include <ExpressionTree.hpp>
+
+#include <stack>
+
+#include <exceptions.hpp>
+
+namespace polishd {
+
+    template<typename T>
+    BasicExpressionTree<T>::BasicExpressionTree(const Expression& expression)
+    {
+        m_nodes.reserve(expression.size());
+        std::stack<size_t> operands;
+        for (const Unit& unit: expression)
+        {
+            // the selection is rebuilt from its `Select` unit
+            if (unit.type == TokenType::Condition || unit.type == TokenType::Alternative)
+                continue;
+            Node node {.unit = unit};
+            for (size_t i = arity(unit.type); i > 0; --i)
+            {
+                node.children[i - 1] = operands.top();
+                operands.pop();
+            }
+            operands.push(add(node));
+        }
+        m_root = operands.top();
+    }
+
+    template<typename T>
+    auto BasicExpressionTree<T>::emit() const -> Expression
+    {
+        Expression expression;
+        expression.reserve(m_nodes.size());
+        emit(m_root, expression);
+        return expression;
+    }
+
+    template<typename T>
+    void BasicExpressionTree<T>::emit(size_t index, Expression& expression) const
+    {
+        const Node& node = m_nodes[index];
+        if (node.unit.type == TokenType::Select)
+        {
+            emit(node.children[0], expression);
+            const size_t condition = expression.size();
+            expression.push_back({.type = TokenType::Condition, .jump = 0});
+            emit(node.children[1], expression);
+            const size_t alternative = expression.size();
+            expression.push_back({.type = TokenType::Alternative, .jump = 0});
+            expression[condition].jump = expression.size();
+            emit(node.children[2], expression);
+            expression[alternative].jump = expression.size() + 1;
+            expression.push_back(node.unit);
+            return;
+        }
+        for (size_t i = 0; i < arity(node.unit.type); ++i)
+            emit(node.children[i], expression);
+        expression.push_back(node.unit);
+    }
+
+    template<typename T>
+    size_t BasicExpressionTree<T>::root() const
+    {
+        return m_root;
+    }
+
+    template<typename T>
+    void BasicExpressionTree<T>::set_root(size_t index)
+    {
+        m_root = index;
+    }
+
+    template<typename T>
+    auto BasicExpressionTree<T>::node(size_t index) const -> const Node&
+    {
+        return m_nodes[index];
+    }
+
+    template<typename T>
+    auto BasicExpressionTree<T>::node(size_t index) -> Node&
+    {
+        return m_nodes[index];
+    }
+
+    template<typename T>
+    size_t BasicExpressionTree<T>::add(const Node& node)
+    {
+        m_nodes.push_back(node);
+        return m_nodes.size() - 1;
+    }
+
+    template<typename T>
+    bool BasicExpressionTree<T>::uses_argument(size_t index, size_t arg_index) const
+    {
+        const Node& node = m_nodes[index];
+        if (node.unit.type == TokenType::Argument)
+            return node.unit.arg_index == arg_index;
+        for (size_t i = 0; i < arity(node.unit.type); ++i)
+        {
+            if (uses_argument(node.children[i], arg_index))
+                return true;
+        }
+        return false;
+    }
+
+    template<typename T>
+    size_t BasicExpressionTree<T>::arity(TokenType type)
+    {
+        switch (type)
+        {
+            case TokenType::Number:
+            case TokenType::Argument:
+                return 0;
+            case TokenType::Prefix:
+            case TokenType::Stateful:
+            case TokenType::Memoized:
+            case TokenType::Postfix:
+            case TokenType::Power:
+                return 1;
+            case TokenType::Binary:
+                return 2;
+            case TokenType::Select:
+            case TokenType::MultiplyAdd:
+                return 3;
+            default:
+                throw UnexpectedUnitError(type);
+        }
+    }
+
+    template class BasicExpressionTree<float>;
+    template class BasicExpressionTree<double>;
+    template class BasicExpressionTree<long double>;
+
+} // namespace polishd
@@ -0,0 +1,60 @@
+#ifndef INC_POLISHD_EXPRESSION_TREE_HPP
+#define INC_POLISHD_EXPRESSION_TREE_HPP
+
+#include <array>
+#include <vector>
+
+#include <Token.hpp>
+#include <Function.hpp>
+
+namespace polishd {
+
+    // The syntax tree of a compiled expression, for the passes
+    // that are easier to express on operands than on the postfix units.
+    // A selection is a single node with the condition, the consequent and the alternative as children.
+    template<typename T>
+    class BasicExpressionTree
+    {
+    public:
+        using Function = BasicFunction<T>;
+        using Unit = typename Function::Unit;
+        using Expression = typename Function::Expression;
+
+        struct Node
+        {
+            Unit unit;
+            std::array<size_t, 3> children {};
+        };
+
+        explicit BasicExpressionTree(const Expression& expression);
+
+        // Converts the tree back to postfix units
+        [[nodiscard]] Expression emit() const;
+
+        [[nodiscard]] size_t root() const;
+        void set_root(size_t index);
+
+        [[nodiscard]] const Node& node(size_t index) const;
+        Node& node(size_t index);
+        size_t add(const Node& node);
+
+        // Whether the subtree uses the argument
+        [[nodiscard]] bool uses_argument(size_t index, size_t arg_index) const;
+
+        static size_t arity(TokenType type);
+
+    private:
+        void emit(size_t index, Expression& expression) const;
+
+    private:
+        std::vector<Node> m_nodes;
+        size_t m_root = 0;
+    };
+
+    extern template class BasicExpressionTree<float>;
+    extern template class BasicExpressionTree<double>;
+    extern template class BasicExpressionTree<long double>;
+
+} // namespace polishd
+
+#endif // INC_POLISHD_EXPRESSION_TREE_HPP
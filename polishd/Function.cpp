@@ -1,98 +1,1335 @@
 #include <Function.hpp>
 
 #include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <exception>
+#include <mutex>
+#include <optional>
 
 #include <exceptions.hpp>
+#include <ExpressionTree.hpp>
 
 namespace polishd {
 
-    double Function::evaluate(const Args& args) const
+    namespace
     {
+
+        // The accumulators of a reduction over a range of rows
+        template<typename T>
+        struct Partial
+        {
+            // Independent compensated sums of every `Lanes`-th value,
+            // so that consecutive additions do not wait for each other
+            static constexpr size_t Lanes = 4;
+            std::array<T, Lanes> sums {};
+            // Neumaier's compensations of the rounding errors of `sums`
+            std::array<T, Lanes> compensations {};
+            T min = std::numeric_limits<T>::infinity();
+            T max = -std::numeric_limits<T>::infinity();
+            size_t count = 0;
+
+            // Once the sum is infinite or NaN it stays so, or becomes NaN,
+            // and the compensation of its finite part is kept out of it, as `inf - inf` would be NaN
+            static void add(T& sum, T& compensation, T x)
+            {
+                const T t = sum + x;
+                const T error = std::abs(sum) >= std::abs(x) ? (sum - t) + x : (x - t) + sum;
+                compensation += std::isfinite(t) ? error : T(0);
+                sum = t;
+            }
+
+            void fold(const BasicReduction<T>& reduction, const T* values, size_t n)
+            {
+                using Kind = typename BasicReduction<T>::Kind;
+                switch (reduction.kind)
+                {
+                    case Kind::Sum:
+                    case Kind::Mean:
+                    {
+                        size_t i = 0;
+                        for (; i + Lanes <= n; i += Lanes)
+                        {
+                            for (size_t lane = 0; lane < Lanes; ++lane)
+                                add(sums[lane], compensations[lane], values[i + lane]);
+                        }
+                        for (; i < n; ++i)
+                            add(sums[0], compensations[0], values[i]);
+                        break;
+                    }
+                    case Kind::Min:
+                        for (size_t i = 0; i < n; ++i)
+                            min = values[i] < min ? values[i] : min;
+                        break;
+                    case Kind::Max:
+                        for (size_t i = 0; i < n; ++i)
+                            max = values[i] > max ? values[i] : max;
+                        break;
+                    case Kind::CountAbove:
+                        for (size_t i = 0; i < n; ++i)
+                            count += values[i] > reduction.threshold;
+                        break;
+                }
+            }
+
+            void merge(const Partial& other)
+            {
+                for (size_t lane = 0; lane < Lanes; ++lane)
+                {
+                    add(sums[lane], compensations[lane], other.sums[lane]);
+                    compensations[lane] += other.compensations[lane];
+                }
+                min = other.min < min ? other.min : min;
+                max = other.max > max ? other.max : max;
+                count += other.count;
+            }
+
+            T total() const
+            {
+                T sum = T(0), compensation = T(0);
+                for (size_t lane = 0; lane < Lanes; ++lane)
+                {
+                    add(sum, compensation, sums[lane]);
+                    compensation += compensations[lane];
+                }
+                return sum + compensation;
+            }
+
+            T result(const BasicReduction<T>& reduction, size_t rows) const
+            {
+                using Kind = typename BasicReduction<T>::Kind;
+                switch (reduction.kind)
+                {
+                    case Kind::Sum:
+                        return total();
+                    case Kind::Mean:
+                        return rows ? total() / static_cast<T>(rows) : std::numeric_limits<T>::quiet_NaN();
+                    case Kind::Min:
+                        return min;
+                    case Kind::Max:
+                        return max;
+                    case Kind::CountAbove:
+                        return static_cast<T>(count);
+                }
+                return std::numeric_limits<T>::quiet_NaN();
+            }
+        };
+
+    }
+
+    template<typename T>
+    T BasicFunction<T>::evaluate(const Args& args) const
+    {
+        const Expected<T> result = try_evaluate(args);
+        if (!result)
+            result.error().raise(m_source.infix);
+        return *result;
+    }
+
+    template<typename T>
+    Expected<T> BasicFunction<T>::try_evaluate(const Args& args) const
+    {
+        if (!m_stateful.empty())
+            return Error {.code = ErrorCode::StatefulFunction};
         // prepare argument values
-        std::vector<double> arg_values;
-        arg_values.reserve(m_arg_names.size());
-        for(auto m_arg_name : m_arg_names)
+        std::vector<T> arg_values;
+        arg_values.reserve(m_source.arg_names.size());
+        for(auto m_arg_name : m_source.arg_names)
         {
             auto lookup = args.find(m_arg_name);
             if(lookup == args.end())
-                throw MissingArgumentError(std::string(m_arg_name));
+                return missing_argument(m_arg_name);
             arg_values.push_back(lookup->second);
         }
-        // evaluate
+        return try_evaluate(std::span<const T>(arg_values));
+    }
+
+    template<typename T>
+    T BasicFunction<T>::evaluate(std::span<const T> arg_values) const
+    {
+        const Expected<T> result = try_evaluate(arg_values);
+        if (!result)
+            result.error().raise(m_source.infix);
+        return *result;
+    }
+
+    template<typename T>
+    Expected<T> BasicFunction<T>::try_evaluate(std::span<const T> arg_values) const
+    {
+        if (!m_stateful.empty())
+            return Error {.code = ErrorCode::StatefulFunction};
+        if (arg_values.size() < m_source.arg_names.size())
+            return missing_argument(m_source.arg_names[arg_values.size()]);
+#ifdef POLISHD_INSTRUMENTATION
+        if (instrumentation::enabled() && m_counters.count(1)) [[unlikely]]
+        {
+            instrumentation::UnitProfile profile;
+            const T result = run<true>(arg_values, &profile);
+            m_counters.record(profile);
+            return result;
+        }
+#endif
+        return run<false>(arg_values, nullptr);
+    }
+
+    template<typename T>
+    template<bool Profiled>
+    T BasicFunction<T>::run(std::span<const T> arg_values, [[maybe_unused]] instrumentation::UnitProfile* profile) const
+    {
+        const Program& program = *m_program;
         Stack stack;
-        double a, b;
-        for (const Unit unit: m_expression)
+        T a, b;
+        for (size_t i = 0; i < program.opcodes.size(); ++i)
         {
-            switch(unit.type)
+            const TokenType opcode = program.opcodes[i];
+            const uint16_t operand = program.operands[i];
+            [[maybe_unused]] Clock::time_point start;
+            if constexpr (Profiled)
+                start = Clock::now();
+            switch(opcode)
             {
                 case TokenType::Number:
-                    stack.push(unit.number);
+                    stack.push(m_numbers[operand]);
                     break;
                 case TokenType::Prefix:
                 case TokenType::Postfix:
                     a = stack.top();
                     stack.pop();
-                    stack.push(unit.unary(a));
+                    stack.push(program.unary[operand](a));
                     break;
                 case TokenType::Binary:
                     b = stack.top();
                     stack.pop();
                     a = stack.top();
                     stack.pop();
-                    stack.push(unit.binary(a, b));
+                    stack.push(program.binary[operand](a, b));
+                    break;
+                case TokenType::Power:
+                    stack.top() = power(stack.top(), static_cast<int16_t>(operand));
+                    break;
+                case TokenType::Memoized:
+                    stack.top() = (*program.memos[operand])(stack.top());
                     break;
+                case TokenType::MultiplyAdd:
+                {
+                    const T c = stack.top();
+                    stack.pop();
+                    b = stack.top();
+                    stack.pop();
+                    a = stack.top();
+                    stack.top() = std::fma(a, b, c);
+                    break;
+                }
                 case TokenType::Argument:
-                    stack.push(arg_values[unit.arg_index]);
+                    stack.push(arg_values[operand]);
+                    break;
+                case TokenType::Condition:
+                    // only the selected branch is evaluated
+                    a = stack.top();
+                    stack.pop();
+                    if (a == T(0))
+                        i = operand - 1;
+                    break;
+                case TokenType::Alternative:
+                    i = operand - 1;
+                    break;
+                case TokenType::Select:
                     break;
                 default:
-                    throw UnexpectedUnitError(unit.type);
+                    throw UnexpectedUnitError(opcode);
 
             }
+            if constexpr (Profiled)
+                profile_unit(*profile, opcode, start);
         }
         return stack.top();
     }
 
-    double Function::evaluate() const
+    template<typename T>
+    T BasicFunction<T>::evaluate() const
     {
         const Args args;
         return evaluate(args);
     }
 
-    double Function::operator()(const Args& args) const
+    template<typename T>
+    void BasicFunction<T>::evaluate(const Columns& columns, T* out, size_t count) const
+    {
+        const Expected<void> result = try_evaluate(columns, out, count);
+        if (!result)
+            result.error().raise(m_source.infix);
+    }
+
+    template<typename T>
+    Expected<void> BasicFunction<T>::try_evaluate(const Columns& columns, T* out, size_t count) const
+    {
+        if (!m_stateful.empty())
+            return Error {.code = ErrorCode::StatefulFunction};
+        const Expected<std::vector<const T*>> arg_columns = resolve_columns(columns);
+        if (!arg_columns)
+            return arg_columns.error();
+        const auto write = [out](const T* values, size_t offset, size_t n) { std::copy_n(values, n, out + offset); };
+#ifdef POLISHD_INSTRUMENTATION
+        if (instrumentation::enabled() && m_counters.count(count)) [[unlikely]]
+        {
+            Workspace workspace = make_workspace();
+            instrumentation::UnitProfile profile;
+            run<true>(*arg_columns, count, workspace, &profile, write);
+            m_counters.record(profile);
+            return {};
+        }
+#endif
+        Workspace workspace = make_workspace();
+        run<false>(*arg_columns, count, workspace, nullptr, write);
+        return {};
+    }
+
+    template<typename T>
+    void BasicFunction<T>::evaluate_each(std::span<const BasicFunction* const> functions, const Args& args, T* out)
+    {
+        // the positions of the functions running each program, the programs in order of their first function
+        std::unordered_map<const Program*, std::vector<size_t>> positions_of;
+        std::vector<const Program*> programs;
+        for (size_t i = 0; i < functions.size(); ++i)
+        {
+            const auto [lookup, added] = positions_of.try_emplace(functions[i]->m_program.get());
+            if (added)
+                programs.push_back(lookup->first);
+            lookup->second.push_back(i);
+        }
+        for (const Program* program: programs)
+        {
+            const std::vector<size_t>& positions = positions_of[program];
+            const BasicFunction& first = *functions[positions.front()];
+            if (positions.size() == 1 || !first.m_stateful.empty())
+            {
+                for (const size_t i: positions)
+                    out[i] = functions[i]->evaluate(args);
+                continue;
+            }
+            // a column for each argument and then for each number, with a row for each function
+            const size_t rows = positions.size();
+            const size_t arg_count = first.m_source.arg_names.size();
+            const size_t number_count = first.m_numbers.size();
+            std::vector<T> values((arg_count + number_count) * rows);
+            for (size_t row = 0; row < rows; ++row)
+            {
+                const BasicFunction& f = *functions[positions[row]];
+                const bool same_names = row > 0 && f.m_source.arg_names == functions[positions[row - 1]]->m_source.arg_names;
+                for (size_t a = 0; a < arg_count; ++a)
+                {
+                    T& value = values[a * rows + row];
+                    if (same_names)
+                    {
+                        value = values[a * rows + row - 1];
+                        continue;
+                    }
+                    const auto lookup = args.find(f.m_source.arg_names[a]);
+                    if (lookup == args.end())
+                        f.missing_argument(f.m_source.arg_names[a]).raise(f.m_source.infix);
+                    value = lookup->second;
+                }
+                for (size_t number = 0; number < number_count; ++number)
+                    values[(arg_count + number) * rows + row] = f.m_numbers[number];
+            }
+            std::vector<const T*> arg_columns(arg_count);
+            for (size_t a = 0; a < arg_count; ++a)
+                arg_columns[a] = values.data() + a * rows;
+            Workspace workspace = first.make_workspace();
+            workspace.number_columns.resize(number_count);
+            for (size_t number = 0; number < number_count; ++number)
+                workspace.number_columns[number] = values.data() + (arg_count + number) * rows;
+            first.template run<false>(arg_columns, rows, workspace, nullptr, [&](const T* results, size_t offset, size_t n)
+            {
+                for (size_t k = 0; k < n; ++k)
+                    out[positions[offset + k]] = results[k];
+            });
+        }
+    }
+
+    template<typename T>
+    T BasicFunction<T>::reduce(const Columns& columns, size_t count, const Reduction& reduction) const
+    {
+        const Expected<T> result = try_reduce(columns, count, reduction);
+        if (!result)
+            result.error().raise(m_source.infix);
+        return *result;
+    }
+
+    template<typename T>
+    Expected<T> BasicFunction<T>::try_reduce(const Columns& columns, size_t count, const Reduction& reduction) const
+    {
+        if (!m_stateful.empty())
+            return Error {.code = ErrorCode::StatefulFunction};
+        const Expected<std::vector<const T*>> arg_columns = resolve_columns(columns);
+        if (!arg_columns)
+            return arg_columns.error();
+#ifdef POLISHD_INSTRUMENTATION
+        if (instrumentation::enabled() && m_counters.count(count)) [[unlikely]]
+        {
+            // a single thread, as the profile is not shared between threads
+            Workspace workspace = make_workspace();
+            instrumentation::UnitProfile profile;
+            Partial<T> partial;
+            run<true>(*arg_columns, count, workspace, &profile,
+                      [&](const T* values, size_t, size_t n) { partial.fold(reduction, values, n); });
+            m_counters.record(profile);
+            return partial.result(reduction, count);
+        }
+#endif
+        const size_t hardware = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        const size_t threads = std::clamp<size_t>(count / MinRowsPerThread, 1,
+                                                  reduction.max_threads ? reduction.max_threads : hardware);
+        // Each thread gets a range of whole steps and folds into a local accumulator,
+        // the partials are merged in order of the ranges once all threads are done.
+        const size_t steps = (count + BatchSize - 1) / BatchSize;
+        std::vector<Partial<T>> partials(threads);
+        std::vector<std::exception_ptr> failures(threads);
+        const auto reduce_range = [&](size_t thread)
+        {
+            try
+            {
+                const size_t begin = std::min(count, steps * thread / threads * BatchSize);
+                const size_t end = std::min(count, steps * (thread + 1) / threads * BatchSize);
+                std::vector<const T*> range_columns = *arg_columns;
+                for (const T*& column: range_columns)
+                    column += begin;
+                Workspace workspace = make_workspace();
+                Partial<T> partial;
+                run<false>(range_columns, end - begin, workspace, nullptr,
+                           [&](const T* values, size_t, size_t n) { partial.fold(reduction, values, n); });
+                partials[thread] = partial;
+            }
+            catch (...)
+            {
+                failures[thread] = std::current_exception();
+            }
+        };
+        {
+            std::vector<std::jthread> workers;
+            workers.reserve(threads - 1);
+            for (size_t thread = 1; thread < threads; ++thread)
+                workers.emplace_back(reduce_range, thread);
+            reduce_range(0);
+        }
+        for (const std::exception_ptr& failure: failures)
+        {
+            if (failure)
+                std::rethrow_exception(failure);
+        }
+        for (size_t thread = 1; thread < threads; ++thread)
+            partials[0].merge(partials[thread]);
+        return partials[0].result(reduction, count);
+    }
+
+    template<typename T>
+    void BasicFunction<T>::sweep(std::span<const SweepAxis> axes, T* out) const
+    {
+        const Expected<void> result = try_sweep(axes, out);
+        if (!result)
+            result.error().raise(m_source.infix);
+    }
+
+    template<typename T>
+    void BasicFunction<T>::sweep(std::span<const SweepAxis> axes, const SweepConsumer& consume) const
+    {
+        const Expected<void> result = try_sweep(axes, consume);
+        if (!result)
+            result.error().raise(m_source.infix);
+    }
+
+    template<typename T>
+    Expected<void> BasicFunction<T>::try_sweep(std::span<const SweepAxis> axes, T* out) const
+    {
+        return try_sweep(axes, [out](const T* results, size_t first, size_t count) { std::copy_n(results, count, out + first); });
+    }
+
+    template<typename T>
+    Expected<void> BasicFunction<T>::try_sweep(std::span<const SweepAxis> axes, const SweepConsumer& consume) const
+    {
+        if (!m_stateful.empty())
+            return Error {.code = ErrorCode::StatefulFunction};
+        const size_t arg_count = m_source.arg_names.size();
+        std::vector<size_t> arg_axes(arg_count);
+        for (size_t a = 0; a < arg_count; ++a)
+        {
+            const auto axis = std::ranges::find(axes, m_source.arg_names[a], &SweepAxis::name);
+            if (axis == axes.end())
+                return missing_argument(m_source.arg_names[a]);
+            arg_axes[a] = axis - axes.begin();
+        }
+        for (const SweepAxis& axis: axes)
+        {
+            if (axis.values.empty())
+                return {};
+        }
+        // The inner axes are the last ones, as few as give at least `BatchSize` points,
+        // the outer axes take one combination of their values at a time.
+        // The first inner axis is split into tiles of as few values as give at least `BatchSize` points,
+        // so that the columns of the inner axes stay below `2 * BatchSize` values whatever the size of that axis.
+        size_t split = axes.size();
+        size_t inner_count = 1;
+        while (split > 0 && inner_count < BatchSize)
+            inner_count *= axes[--split].values.size();
+        size_t outer_count = 1;
+        for (size_t i = 0; i < split; ++i)
+            outer_count *= axes[i].values.size();
+        const size_t split_size = split < axes.size() ? axes[split].values.size() : 1;
+        // points per value of the first inner axis, and of its tiles
+        const size_t below = inner_count / split_size;
+        const size_t tile = std::min(split_size, (BatchSize + below - 1) / below);
+        const size_t tile_count = tile * below;
+
+        // The level of a subtree is one more than the last outer axis it depends on, 0 for none,
+        // or `Inner` if it depends on an inner axis.
+        // The largest subtrees of the other levels are hoisted, i.e. replaced by numbers
+        // and evaluated on their own whenever an axis up to their level changes.
+        constexpr size_t Inner = std::numeric_limits<size_t>::max();
+        struct Hoisted
+        {
+            Expression expression;
+            size_t level;
+            size_t number;
+        };
+        BasicExpressionTree<T> tree(disassemble());
+        // the root is the last node of a tree built from postfix units
+        std::vector<size_t> levels(tree.root() + 1);
+        const auto level_of = [&](const auto& level_of, size_t index) -> size_t
+        {
+            const typename BasicExpressionTree<T>::Node& node = tree.node(index);
+            size_t level = 0;
+            if (node.unit.type == TokenType::Argument)
+            {
+                const size_t axis = arg_axes[node.unit.arg_index];
+                level = axis < split ? axis + 1 : Inner;
+            }
+            for (size_t i = 0; i < BasicExpressionTree<T>::arity(node.unit.type); ++i)
+                level = std::max(level, level_of(level_of, node.children[i]));
+            levels[index] = level;
+            return level;
+        };
+        std::vector<Hoisted> hoisted;
+        // numbered in the order `emit` and then `assemble` number them
+        size_t numbers = 0;
+        const auto hoist = [&](const auto& hoist, size_t index) -> void
+        {
+            typename BasicExpressionTree<T>::Node& node = tree.node(index);
+            if (node.unit.type == TokenType::Number)
+            {
+                ++numbers;
+                return;
+            }
+            if (levels[index] != Inner)
+            {
+                BasicExpressionTree<T> subtree = tree;
+                subtree.set_root(index);
+                hoisted.push_back({.expression = subtree.emit(), .level = levels[index], .number = numbers++});
+                node = {.unit = {.type = TokenType::Number, .number = T(0)}};
+                return;
+            }
+            for (size_t i = 0; i < BasicExpressionTree<T>::arity(node.unit.type); ++i)
+                hoist(hoist, node.children[i]);
+        };
+        level_of(level_of, tree.root());
+        hoist(hoist, tree.root());
+
+        std::unordered_map<std::string_view, size_t> arg_indices;
+        for (size_t a = 0; a < arg_count; ++a)
+            arg_indices.emplace(m_source.arg_names[a], a);
+        BasicFunction inner(tree.emit(), arg_indices, m_source.infix, m_postfix);
+        std::vector<BasicFunction> hoisted_functions;
+        hoisted_functions.reserve(hoisted.size());
+        for (Hoisted& h: hoisted)
+            hoisted_functions.push_back(BasicFunction(std::move(h.expression), arg_indices, m_source.infix, m_postfix));
+
+        // The columns of the inner axes repeat each of their values for each combination of the axes after them,
+        // and all their values for each combination of the axes before them, over a tile.
+        // A single inner axis is its own column, offset to the tile.
+        std::vector<std::vector<T>> inner_values(axes.size());
+        std::vector<const T*> arg_columns(arg_count);
+        size_t stride = 1;
+        for (size_t axis = axes.size(); axis-- > split + 1;)
+        {
+            const std::vector<T>& values = axes[axis].values;
+            if (values.size() < tile_count)
+            {
+                inner_values[axis].resize(tile_count);
+                for (size_t i = 0; i < tile_count; ++i)
+                    inner_values[axis][i] = values[i / stride % values.size()];
+            }
+            stride *= values.size();
+        }
+        if (below > 1)
+            inner_values[split].resize(tile_count);
+        // the column of the first inner axis for the tile starting at its value `start`
+        const auto split_column = [&](size_t start) -> const T*
+        {
+            const std::vector<T>& values = axes[split].values;
+            if (below == 1)
+                return values.data() + start;
+            const size_t count = std::min(tile, split_size - start) * below;
+            for (size_t i = 0; i < count; ++i)
+                inner_values[split][i] = values[start + i / below];
+            return inner_values[split].data();
+        };
+        for (size_t a = 0; a < arg_count; ++a)
+        {
+            const size_t axis = arg_axes[a];
+            if (axis > split)
+                arg_columns[a] = inner_values[axis].empty() ? axes[axis].values.data() : inner_values[axis].data();
+        }
+
+        // The outer axes are stepped like an odometer, the last one fastest
+        std::vector<size_t> positions(split, 0);
+        std::vector<T> arg_values(arg_count, T(0));
+        Workspace workspace = inner.make_workspace();
+        for (size_t outer = 0; outer < outer_count; ++outer)
+        {
+            // the first outer axis which changed since the previous combination
+            size_t changed = 0;
+            if (outer > 0)
+            {
+                changed = split - 1;
+                while (++positions[changed] == axes[changed].values.size())
+                    positions[changed--] = 0;
+            }
+            for (size_t a = 0; a < arg_count; ++a)
+            {
+                if (arg_axes[a] < split)
+                    arg_values[a] = axes[arg_axes[a]].values[positions[arg_axes[a]]];
+            }
+            for (size_t h = 0; h < hoisted.size(); ++h)
+            {
+                if (outer == 0 || hoisted[h].level > changed)
+                    inner.m_numbers[hoisted[h].number] = hoisted_functions[h].template run<false>(arg_values, nullptr);
+            }
+            for (size_t start = 0; start < split_size; start += tile)
+            {
+                // a single tile is filled once
+                if (tile < split_size || outer == 0)
+                {
+                    const T* const column = split < axes.size() ? split_column(start) : nullptr;
+                    for (size_t a = 0; a < arg_count; ++a)
+                    {
+                        if (arg_axes[a] == split)
+                            arg_columns[a] = column;
+                    }
+                }
+                const size_t first = outer * inner_count + start * below;
+                const size_t count = std::min(tile, split_size - start) * below;
+                inner.template run<false>(arg_columns, count, workspace, nullptr, [&](const T* results, size_t offset, size_t n)
+                {
+                    consume(results, first + offset, n);
+                });
+            }
+        }
+        return {};
+    }
+
+    template<typename T>
+    template<bool Profiled, typename Consume>
+    void BasicFunction<T>::run(const std::vector<const T*>& arg_columns, size_t count, Workspace& workspace,
+                               [[maybe_unused]] instrumentation::UnitProfile* profile, Consume&& consume) const
+    {
+        // Each stack slot owns a scratch buffer of `BatchSize` values,
+        // but may point directly to an argument column to avoid copying it.
+        const Program& program = *m_program;
+        std::vector<T>& scratch = workspace.scratch;
+        std::vector<const T*>& slots = workspace.slots;
+        for (size_t offset = 0; offset < count; offset += BatchSize)
+        {
+            const size_t n = std::min(BatchSize, count - offset);
+            size_t top = 0; // number of occupied slots
+            for (size_t u = 0; u < program.opcodes.size(); ++u)
+            {
+                const TokenType opcode = program.opcodes[u];
+                const uint16_t operand = program.operands[u];
+                [[maybe_unused]] Clock::time_point start;
+                if constexpr (Profiled)
+                    start = Clock::now();
+                switch(opcode)
+                {
+                    case TokenType::Number:
+                    {
+                        if (!workspace.number_columns.empty())
+                        {
+                            slots[top++] = workspace.number_columns[operand] + offset;
+                            break;
+                        }
+                        T* const buffer = scratch.data() + top * BatchSize;
+                        std::fill_n(buffer, n, m_numbers[operand]);
+                        slots[top++] = buffer;
+                        break;
+                    }
+                    case TokenType::Argument:
+                        slots[top++] = arg_columns[operand] + offset;
+                        break;
+                    case TokenType::Prefix:
+                    case TokenType::Postfix:
+                    {
+                        T* const buffer = scratch.data() + (top - 1) * BatchSize;
+                        const T* const a = slots[top - 1];
+                        if (const kernels::UnaryKernel<T> kernel = program.unary_kernels[operand])
+                            kernel(a, buffer, n);
+                        else
+                        {
+                            const typename Grammar::Unary unary = program.unary[operand];
+                            for (size_t i = 0; i < n; ++i)
+                                buffer[i] = unary(a[i]);
+                        }
+                        slots[top - 1] = buffer;
+                        break;
+                    }
+                    case TokenType::Memoized:
+                    {
+                        T* const buffer = scratch.data() + (top - 1) * BatchSize;
+                        const T* const a = slots[top - 1];
+                        const BasicMemoizedOperator<T>& memo = *program.memos[operand];
+                        for (size_t i = 0; i < n; ++i)
+                            buffer[i] = memo(a[i]);
+                        slots[top - 1] = buffer;
+                        break;
+                    }
+                    case TokenType::Binary:
+                    {
+                        --top;
+                        T* const buffer = scratch.data() + (top - 1) * BatchSize;
+                        const T* const a = slots[top - 1];
+                        const T* const b = slots[top];
+                        if (const kernels::BinaryKernel<T> kernel = program.binary_kernels[operand])
+                            kernel(a, b, buffer, n);
+                        else
+                        {
+                            const typename Grammar::Binary binary = program.binary[operand];
+                            for (size_t i = 0; i < n; ++i)
+                                buffer[i] = binary(a[i], b[i]);
+                        }
+                        slots[top - 1] = buffer;
+                        break;
+                    }
+                    case TokenType::Power:
+                    {
+                        T* const buffer = scratch.data() + (top - 1) * BatchSize;
+                        const T* const a = slots[top - 1];
+                        const int exponent = static_cast<int16_t>(operand);
+                        // the most common exponents get loops simple enough to be vectorized
+                        if (exponent == 2)
+                        {
+                            for (size_t i = 0; i < n; ++i)
+                                buffer[i] = a[i] * a[i];
+                        }
+                        else if (exponent == 3)
+                        {
+                            for (size_t i = 0; i < n; ++i)
+                                buffer[i] = a[i] * a[i] * a[i];
+                        }
+                        else
+                            power(a, buffer, n, exponent);
+                        slots[top - 1] = buffer;
+                        break;
+                    }
+                    case TokenType::MultiplyAdd:
+                    {
+                        top -= 2;
+                        T* const buffer = scratch.data() + (top - 1) * BatchSize;
+                        const T* const a = slots[top - 1];
+                        const T* const b = slots[top];
+                        const T* const c = slots[top + 1];
+                        if (program.multiply_add_kernel)
+                            program.multiply_add_kernel(a, b, c, buffer, n);
+                        else
+                        {
+                            // without fused multiply-adds, `std::fma` is a call per row,
+                            // so the product is rounded before the sum, like separate operators
+                            for (size_t i = 0; i < n; ++i)
+                                buffer[i] = a[i] * b[i];
+                            for (size_t i = 0; i < n; ++i)
+                                buffer[i] += c[i];
+                        }
+                        slots[top - 1] = buffer;
+                        break;
+                    }
+                    case TokenType::Stateful:
+                    {
+                        // the samples are fed in order, so the column is the same as the rows one by one
+                        T* const buffer = scratch.data() + (top - 1) * BatchSize;
+                        const T* const a = slots[top - 1];
+                        const StatefulUnit& stateful = m_stateful[operand];
+                        std::byte* const state = workspace.state.data() + stateful.offset;
+                        for (size_t i = 0; i < n; ++i)
+                            buffer[i] = stateful.op.step(state, stateful.op, a[i]);
+                        slots[top - 1] = buffer;
+                        break;
+                    }
+                    case TokenType::Condition:
+                    case TokenType::Alternative:
+                        // both branches are evaluated for all rows and blended by `Select`
+                        break;
+                    case TokenType::Select:
+                    {
+                        top -= 2;
+                        T* const buffer = scratch.data() + (top - 1) * BatchSize;
+                        const T* const condition = slots[top - 1];
+                        const T* const a = slots[top];
+                        const T* const b = slots[top + 1];
+                        for (size_t i = 0; i < n; ++i)
+                            buffer[i] = condition[i] != T(0) ? a[i] : b[i];
+                        slots[top - 1] = buffer;
+                        break;
+                    }
+                    default:
+                        throw UnexpectedUnitError(opcode);
+                }
+                if constexpr (Profiled)
+                    profile_unit(*profile, opcode, start);
+            }
+            consume(slots[0], offset, n);
+        }
+    }
+
+    template<typename T>
+    BasicFunction<T> BasicFunction<T>::specialize(const Args& bound) const
+    {
+        const size_t arg_count = m_source.arg_names.size();
+        std::vector<std::optional<T>> values(arg_count);
+        for (size_t a = 0; a < arg_count; ++a)
+        {
+            if (const auto lookup = bound.find(m_source.arg_names[a]); lookup != bound.end())
+                values[a] = lookup->second;
+        }
+        BasicExpressionTree<T> tree(disassemble());
+        tree.set_root(bind(tree, tree.root(), values));
+        Expression expression = tree.emit();
+        // the arguments left, i.e. neither bound nor only in a dropped branch, are renumbered in order
+        std::vector<bool> used(arg_count, false);
+        for (const Unit& unit: expression)
+        {
+            if (unit.type == TokenType::Argument)
+                used[unit.arg_index] = true;
+        }
+        std::vector<size_t> new_indices(arg_count, 0);
+        std::unordered_map<std::string_view, size_t> arg_indices;
+        for (size_t a = 0; a < arg_count; ++a)
+        {
+            if (used[a])
+            {
+                new_indices[a] = arg_indices.size();
+                arg_indices.emplace(m_source.arg_names[a], new_indices[a]);
+            }
+        }
+        for (Unit& unit: expression)
+        {
+            if (unit.type == TokenType::Argument)
+                unit.arg_index = new_indices[unit.arg_index];
+        }
+        // the units keep the indices of their stateful operators, even if a dropped branch held some
+        std::vector<Stateful> stateful;
+        stateful.reserve(m_stateful.size());
+        for (const StatefulUnit& unit: m_stateful)
+            stateful.push_back(unit.op);
+        return BasicFunction(std::move(expression), arg_indices, m_source.infix, m_postfix, std::move(stateful), m_shared_program);
+    }
+
+    template<typename T>
+    size_t BasicFunction<T>::bind(BasicExpressionTree<T>& tree, size_t index, const std::vector<std::optional<T>>& arg_values)
+    {
+        typename BasicExpressionTree<T>::Node& node = tree.node(index);
+        Unit& unit = node.unit;
+        if (unit.type == TokenType::Argument)
+        {
+            if (arg_values[unit.arg_index])
+                unit = {.type = TokenType::Number, .number = *arg_values[unit.arg_index]};
+            return index;
+        }
+        const size_t arity = BasicExpressionTree<T>::arity(unit.type);
+        std::array<T, 3> operands {};
+        bool computable = arity > 0 && unit.type != TokenType::Stateful;
+        for (size_t i = 0; i < arity; ++i)
+        {
+            node.children[i] = bind(tree, node.children[i], arg_values);
+            const Unit& operand = tree.node(node.children[i]).unit;
+            if (operand.type == TokenType::Number)
+                operands[i] = operand.number;
+            else
+                computable = false;
+        }
+        // like the evaluation, only the condition needs to be known to select a branch
+        if (unit.type == TokenType::Select && tree.node(node.children[0]).unit.type == TokenType::Number)
+            return node.children[operands[0] != T(0) ? 1 : 2];
+        if (!computable)
+            return index;
+        T value;
+        switch (unit.type)
+        {
+            case TokenType::Prefix:
+            case TokenType::Postfix:
+                value = unit.unary(operands[0]);
+                break;
+            case TokenType::Memoized:
+                value = (*unit.memo)(operands[0]);
+                break;
+            case TokenType::Power:
+                value = power(operands[0], unit.exponent);
+                break;
+            case TokenType::Binary:
+                value = unit.binary(operands[0], operands[1]);
+                break;
+            case TokenType::MultiplyAdd:
+                value = std::fma(operands[0], operands[1], operands[2]);
+                break;
+            default:
+                return index;
+        }
+        unit = {.type = TokenType::Number, .number = value};
+        return index;
+    }
+
+    template<typename T>
+    T BasicFunction<T>::operator()(const Args& args) const
     {
         return evaluate(args);
     }
 
-    double Function::operator()() const
+    template<typename T>
+    T BasicFunction<T>::operator()() const
     {
         return evaluate();
     }
 
-    const std::string& Function::infix() const
+    template<typename T>
+    const std::string& BasicFunction<T>::infix() const
     {
-        return m_infix;
+        return m_source.infix;
     }
 
-    const std::string& Function::postfix() const
+    template<typename T>
+    const std::string& BasicFunction<T>::postfix() const
     {
         return m_postfix;
     }
 
-    Function::Function(Expression expression,
-                       const std::unordered_map<std::string_view, size_t>& arg_indices,
-                       const std::string& infix,
-                       std::string postfix)
-        : m_expression(std::move(expression)),
-          m_arg_names(arg_indices.size()),
-          m_infix(infix),
+    template<typename T>
+    const std::vector<std::string_view>& BasicFunction<T>::arguments() const
+    {
+        return m_source.arg_names;
+    }
+
+    template<typename T>
+    BasicFunction<T>::BasicFunction(Expression expression,
+                            const std::unordered_map<std::string_view, size_t>& arg_indices,
+                            const std::string& infix,
+                            std::string postfix,
+                            std::vector<Stateful> stateful,
+                            bool share_program)
+        : m_shared_program(share_program),
+          m_stack_depth(stack_depth_of(expression)),
+          m_source(infix, arg_indices),
           m_postfix(std::move(postfix))
+    {
+        Program program = assemble(expression, m_numbers);
+        if (share_program)
+            m_program = intern(std::move(program));
+        else
+            m_program = std::make_shared<const Program>(std::move(program));
+        // each state starts at an offset suitable for any type
+        m_stateful.reserve(stateful.size());
+        for (const Stateful& op: stateful)
+        {
+            m_stateful.push_back({op, m_state_size});
+            m_state_size += (op.state_size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+        }
+    }
+
+    template<typename T>
+    void BasicFunction<T>::run_stream(const std::vector<const T*>& arg_columns, T* out, size_t count,
+                                      Workspace& workspace, instrumentation::UnitProfile* profile) const
+    {
+        const auto write = [out](const T* values, size_t offset, size_t n) { std::copy_n(values, n, out + offset); };
+        if (profile)
+            run<true>(arg_columns, count, workspace, profile, write);
+        else
+            run<false>(arg_columns, count, workspace, nullptr, write);
+    }
+
+    template<typename T>
+    auto BasicFunction<T>::make_workspace() const -> Workspace
+    {
+        Workspace workspace {
+            .scratch = std::vector<T>(m_stack_depth * BatchSize),
+            .slots = std::vector<const T*>(m_stack_depth),
+            .state = std::vector<std::byte>(m_state_size)
+        };
+        init_state(workspace.state.data());
+        return workspace;
+    }
+
+    template<typename T>
+    void BasicFunction<T>::init_state(std::byte* state) const
+    {
+        for (const StatefulUnit& stateful: m_stateful)
+        {
+            if (stateful.op.init)
+                stateful.op.init(state + stateful.offset, stateful.op);
+            else
+                std::fill_n(state + stateful.offset, stateful.op.state_size, std::byte {0});
+        }
+    }
+
+    template<typename T>
+    BasicFunction<T>::Source::Source(const std::string& infix, const std::unordered_map<std::string_view, size_t>& arg_indices)
+        : infix(infix),
+          arg_names(arg_indices.size())
     {
         for(const auto& [arg_name, index] : arg_indices)
+            arg_names[index] = arg_name;
+        // translate arg name string_views to point to this->infix
+        rebase(infix.data());
+    }
+
+    template<typename T>
+    BasicFunction<T>::Source::Source(const Source& other) : infix(other.infix), arg_names(other.arg_names)
+    {
+        rebase(other.infix.data());
+    }
+
+    template<typename T>
+    BasicFunction<T>::Source::Source(Source&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    template<typename T>
+    typename BasicFunction<T>::Source& BasicFunction<T>::Source::operator=(const Source& other)
+    {
+        if (this != &other)
+        {
+            infix = other.infix;
+            arg_names = other.arg_names;
+            rebase(other.infix.data());
+        }
+        return *this;
+    }
+
+    template<typename T>
+    typename BasicFunction<T>::Source& BasicFunction<T>::Source::operator=(Source&& other) noexcept
+    {
+        // a short string is stored inline and changes its address when moved
+        const char* const other_infix = other.infix.data();
+        infix = std::move(other.infix);
+        arg_names = std::move(other.arg_names);
+        rebase(other_infix);
+        return *this;
+    }
+
+    template<typename T>
+    void BasicFunction<T>::Source::rebase(const char* other_infix)
+    {
+        for (std::string_view& arg_name : arg_names)
+            arg_name = std::string_view(infix).substr(arg_name.data() - other_infix, arg_name.size());
+    }
+
+    template<typename T>
+    instrumentation::EvaluationStats BasicFunction<T>::evaluation_stats() const
+    {
+#ifdef POLISHD_INSTRUMENTATION
+        return m_counters.snapshot();
+#else
+        return {};
+#endif
+    }
+
+    template<typename T>
+    void BasicFunction<T>::reset_evaluation_stats() const
+    {
+#ifdef POLISHD_INSTRUMENTATION
+        m_counters.reset();
+#endif
+    }
+
+    template<typename T>
+    bool BasicFunction<T>::shares_program_with(const BasicFunction& other) const
+    {
+        return m_program == other.m_program;
+    }
+
+    template<typename T>
+    std::array<size_t, TokenTypeCount> BasicFunction<T>::unit_histogram() const
+    {
+        std::array<size_t, TokenTypeCount> histogram {};
+        for (const TokenType opcode: m_program->opcodes)
+            ++histogram[static_cast<size_t>(opcode)];
+        return histogram;
+    }
+
+    template<typename T>
+    void BasicFunction<T>::profile_unit(instrumentation::UnitProfile& profile, TokenType type, Clock::time_point start)
+    {
+        const auto index = static_cast<size_t>(type);
+        ++profile.counts[index];
+        profile.time[index] += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+    }
+
+    template<typename T>
+    Expected<std::vector<const T*>> BasicFunction<T>::resolve_columns(const Columns& columns) const
+    {
+        std::vector<const T*> arg_columns;
+        arg_columns.reserve(m_source.arg_names.size());
+        for(auto m_arg_name : m_source.arg_names)
+        {
+            auto lookup = columns.find(m_arg_name);
+            if(lookup == columns.end())
+                return missing_argument(m_arg_name);
+            arg_columns.push_back(lookup->second);
+        }
+        return arg_columns;
+    }
+
+    template<typename T>
+    Error BasicFunction<T>::missing_argument(std::string_view arg_name) const
+    {
+        return {
+            .code = ErrorCode::MissingArgument,
+            .offset = static_cast<uint32_t>(arg_name.data() - m_source.infix.data()),
+            .length = static_cast<uint32_t>(arg_name.size())
+        };
+    }
+
+    template<typename T>
+    T BasicFunction<T>::power(T x, int n)
+    {
+        unsigned exponent = n < 0 ? -static_cast<unsigned>(n) : static_cast<unsigned>(n);
+        T result = T(1);
+        while (exponent)
         {
-            // translate arg name string_views to point to m_infix
-            const size_t start = arg_name.data() - infix.data();
-            m_arg_names[index] = std::string_view(m_infix).substr(start, arg_name.size());
+            if (exponent & 1u)
+                result *= x;
+            x *= x;
+            exponent >>= 1;
         }
+        return n < 0 ? T(1) / result : result;
     }
 
+    template<typename T>
+    void BasicFunction<T>::power(const T* x, T* out, size_t n, int exponent)
+    {
+        // the same products as `power`, each a loop over a block of values
+        constexpr size_t Block = 64;
+        const unsigned magnitude = exponent < 0 ? -static_cast<unsigned>(exponent) : static_cast<unsigned>(exponent);
+        T squares[Block];
+        T results[Block];
+        for (size_t offset = 0; offset < n; offset += Block)
+        {
+            const size_t m = std::min(Block, n - offset);
+            std::copy_n(x + offset, m, squares);
+            std::fill_n(results, m, T(1));
+            for (unsigned remaining = magnitude; remaining; remaining >>= 1)
+            {
+                if (remaining & 1u)
+                {
+                    for (size_t i = 0; i < m; ++i)
+                        results[i] *= squares[i];
+                }
+                if (remaining > 1)
+                {
+                    for (size_t i = 0; i < m; ++i)
+                        squares[i] *= squares[i];
+                }
+            }
+            if (exponent < 0)
+            {
+                for (size_t i = 0; i < m; ++i)
+                    out[offset + i] = T(1) / results[i];
+            }
+            else
+                std::copy_n(results, m, out + offset);
+        }
+    }
+
+    template<typename T>
+    size_t BasicFunction<T>::stack_depth_of(const Expression& expression)
+    {
+        size_t depth = 0, max_depth = 0;
+        for (const Unit& unit: expression)
+        {
+            if (unit.type == TokenType::Number || unit.type == TokenType::Argument)
+                max_depth = std::max(max_depth, ++depth);
+            else if (unit.type == TokenType::Binary)
+                --depth;
+            else if (unit.type == TokenType::Select || unit.type == TokenType::MultiplyAdd)
+                depth -= 2;
+        }
+        return max_depth;
+    }
+
+    template<typename T>
+    auto BasicFunction<T>::assemble(const Expression& expression, std::vector<T>& numbers) -> Program
+    {
+        Program program;
+        program.opcodes.reserve(expression.size());
+        program.operands.reserve(expression.size());
+        std::unordered_map<typename Grammar::Unary, uint16_t> unary_indices;
+        std::unordered_map<typename Grammar::Binary, uint16_t> binary_indices;
+        std::unordered_map<const BasicMemoizedOperator<T>*, uint16_t> memo_indices;
+        for (const Unit& unit: expression)
+        {
+            uint16_t operand = 0;
+            switch (unit.type)
+            {
+                case TokenType::Number:
+                    operand = static_cast<uint16_t>(numbers.size());
+                    numbers.push_back(unit.number);
+                    break;
+                case TokenType::Prefix:
+                case TokenType::Postfix:
+                {
+                    const auto [lookup, added] = unary_indices.try_emplace(unit.unary, program.unary.size());
+                    if (added)
+                    {
+                        program.unary.push_back(unit.unary);
+                        program.unary_kernels.push_back(kernels::find<T>(unit.unary));
+                    }
+                    operand = lookup->second;
+                    break;
+                }
+                case TokenType::Binary:
+                {
+                    const auto [lookup, added] = binary_indices.try_emplace(unit.binary, program.binary.size());
+                    if (added)
+                    {
+                        program.binary.push_back(unit.binary);
+                        program.binary_kernels.push_back(kernels::find<T>(unit.binary));
+                    }
+                    operand = lookup->second;
+                    break;
+                }
+                case TokenType::Memoized:
+                {
+                    const auto [lookup, added] = memo_indices.try_emplace(unit.memo, program.memos.size());
+                    if (added)
+                        program.memos.push_back(unit.memo->shared_from_this());
+                    operand = lookup->second;
+                    break;
+                }
+                case TokenType::Argument:
+                    operand = static_cast<uint16_t>(unit.arg_index);
+                    break;
+                case TokenType::Condition:
+                case TokenType::Alternative:
+                    operand = static_cast<uint16_t>(unit.jump);
+                    break;
+                case TokenType::Power:
+                    operand = static_cast<uint16_t>(static_cast<int16_t>(unit.exponent));
+                    break;
+                case TokenType::Stateful:
+                    operand = static_cast<uint16_t>(unit.stateful);
+                    break;
+                case TokenType::MultiplyAdd:
+                    program.multiply_add_kernel = kernels::find<T>(&kernels::multiply_add<T>);
+                    break;
+                default:
+                    break;
+            }
+            program.opcodes.push_back(unit.type);
+            program.operands.push_back(operand);
+        }
+        return program;
+    }
+
+    template<typename T>
+    auto BasicFunction<T>::intern(Program program) -> std::shared_ptr<const Program>
+    {
+        // Held weakly, so that a program is freed along with its last function,
+        // the entries left empty are swept whenever the table has doubled since the last sweep
+        static std::mutex mutex;
+        static std::unordered_multimap<size_t, std::weak_ptr<const Program>> programs;
+        static size_t sweep_size = 64;
+        const size_t hash = hash_of(program);
+        const std::lock_guard lock(mutex);
+        const auto [begin, end] = programs.equal_range(hash);
+        for (auto entry = begin; entry != end; ++entry)
+        {
+            if (std::shared_ptr<const Program> shared = entry->second.lock(); shared && *shared == program)
+                return shared;
+        }
+        if (programs.size() >= sweep_size)
+        {
+            std::erase_if(programs, [](const auto& entry) { return entry.second.expired(); });
+            sweep_size = std::max<size_t>(64, 2 * programs.size());
+        }
+        std::shared_ptr<const Program> shared = std::make_shared<const Program>(std::move(program));
+        programs.emplace(hash, shared);
+        return shared;
+    }
+
+    template<typename T>
+    size_t BasicFunction<T>::hash_of(const Program& program)
+    {
+        const auto bytes_of = [](const auto& values)
+        {
+            return std::string_view(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(values[0]));
+        };
+        size_t hash = std::hash<std::string_view>()(bytes_of(program.opcodes));
+        const auto mix = [&hash](size_t value) { hash ^= value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2); };
+        mix(std::hash<std::string_view>()(bytes_of(program.operands)));
+        // the kernels follow from the operators
+        for (const typename Grammar::Unary unary: program.unary)
+            mix(std::hash<typename Grammar::Unary>()(unary));
+        for (const typename Grammar::Binary binary: program.binary)
+            mix(std::hash<typename Grammar::Binary>()(binary));
+        for (const std::shared_ptr<const BasicMemoizedOperator<T>>& memo: program.memos)
+            mix(std::hash<const BasicMemoizedOperator<T>*>()(memo.get()));
+        return hash;
+    }
+
+    template<typename T>
+    auto BasicFunction<T>::disassemble() const -> Expression
+    {
+        Expression expression;
+        expression.reserve(m_program->opcodes.size());
+        for (size_t i = 0; i < m_program->opcodes.size(); ++i)
+        {
+            const TokenType opcode = m_program->opcodes[i];
+            const uint16_t operand = m_program->operands[i];
+            switch (opcode)
+            {
+                case TokenType::Number:
+                    expression.push_back({.type = opcode, .number = m_numbers[operand]});
+                    break;
+                case TokenType::Prefix:
+                case TokenType::Postfix:
+                    expression.push_back({.type = opcode, .unary = m_program->unary[operand]});
+                    break;
+                case TokenType::Binary:
+                    expression.push_back({.type = opcode, .binary = m_program->binary[operand]});
+                    break;
+                case TokenType::Memoized:
+                    expression.push_back({.type = opcode, .memo = m_program->memos[operand].get()});
+                    break;
+                case TokenType::Argument:
+                    expression.push_back({.type = opcode, .arg_index = operand});
+                    break;
+                case TokenType::Condition:
+                case TokenType::Alternative:
+                    expression.push_back({.type = opcode, .jump = operand});
+                    break;
+                case TokenType::Power:
+                    expression.push_back({.type = opcode, .exponent = static_cast<int16_t>(operand)});
+                    break;
+                case TokenType::Stateful:
+                    expression.push_back({.type = opcode, .stateful = operand});
+                    break;
+                default:
+                    expression.push_back({.type = opcode, .number = T(0)});
+                    break;
+            }
+        }
+        return expression;
+    }
+
+    template class BasicFunction<float>;
+    template class BasicFunction<double>;
+    template class BasicFunction<long double>;
+
 } // namespace polishd
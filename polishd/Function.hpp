@@ -7,59 +7,293 @@
 #include <forward_list>
 #include <stack>
 #include <vector>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <optional>
+#include <functional>
 
 #include <TransparentStringKeyMap.hpp>
 #include <Token.hpp>
 #include <Grammar.hpp>
+#include <Expected.hpp>
+#include <Instrumentation.hpp>
+#include <Reduction.hpp>
+#include <Sweep.hpp>
+#include <Kernels.hpp>
 
 namespace polishd {
     
-    using Args = TransparentStringKeyMap<double>;
+    template<typename T>
+    using BasicArgs = TransparentStringKeyMap<T>;
+    template<typename T>
+    using BasicColumns = TransparentStringKeyMap<const T*>;
+
+    using Args = BasicArgs<double>;
+    using Columns = BasicColumns<double>;
     
-    class Function
+    template<typename T>
+    class BasicExpressionTree;
+
+    // A compiled expression on the scalar type `T`,
+    // i.e. `float`, `double` or `long double`
+    template<typename T>
+    class BasicFunction
     {
-        friend class CompilingContext;
+        template<typename> friend class BasicCompilingContext;
+        template<typename> friend class BasicExpressionTree;
+        template<typename> friend class BasicOptimizer;
+        template<typename> friend class BasicCodeGenerator;
+        template<typename> friend class BasicStreamEvaluator;
 
     public:
+        using Scalar = T;
+        using Args = BasicArgs<T>;
+        using Columns = BasicColumns<T>;
+        using Reduction = BasicReduction<T>;
+        using SweepAxis = BasicSweepAxis<T>;
+        // Receives the results of consecutive points of a sweep, `results[i]` being the result of the point `first + i`
+        using SweepConsumer = std::function<void(const T* results, size_t first, size_t count)>;
+
+        [[nodiscard]] T evaluate(const Args& args) const;
+        [[nodiscard]] T evaluate() const;
+        // Evaluates the function with the values of the arguments in the order of `arguments()`
+        [[nodiscard]] T evaluate(std::span<const T> arg_values) const;
+
+        // Evaluates the function for `count` rows at once.
+        // Each argument is read from a column of at least `count` values,
+        // and the i-th result is written to `out[i]`.
+        // The operators of `standard_grammar()` run their vectorized kernels, see `kernels::find`,
+        // so a result may differ in the last bit from the single `evaluate` of its row:
+        // for a few percent of the rows using `exp`, `log`, `sin`, `cos` or `pow`,
+        // and for the rows using a fused multiply-add on a CPU without the instructions for it.
+        void evaluate(const Columns& columns, T* out, size_t count) const;
 
-        [[nodiscard]] double evaluate(const Args& args) const;
-        [[nodiscard]] double evaluate() const;
+        // Evaluates each of the `functions` at the same `args`, i.e. `out[i] = functions[i]->evaluate(args)`.
+        // The functions sharing a program, see `CompileOptions::share_programs`, are evaluated at once
+        // like the rows of the batch evaluation, with their numbers read from columns,
+        // and may differ from their single `evaluate` in the last bit like those.
+        static void evaluate_each(std::span<const BasicFunction* const> functions, const Args& args, T* out);
+
+        // Non-throwing variants of `evaluate`.
+        // Use `Error::message(infix())` to get the message of a failure.
+        [[nodiscard]] Expected<T> try_evaluate(const Args& args) const;
+        [[nodiscard]] Expected<T> try_evaluate(std::span<const T> arg_values) const;
+        [[nodiscard]] Expected<void> try_evaluate(const Columns& columns, T* out, size_t count) const;
+
+        // Evaluates the function for `count` rows like the batch `evaluate`,
+        // but folds the results into the `reduction` instead of writing them out.
+        // The results may differ from the single `evaluate` in the last bit like those of the batch `evaluate`.
+        // The rows are split between threads, each folding into its own partial accumulator.
+        [[nodiscard]] T reduce(const Columns& columns, size_t count, const Reduction& reduction) const;
+        [[nodiscard]] Expected<T> try_reduce(const Columns& columns, size_t count, const Reduction& reduction) const;
     
-        double operator()(const Args& args) const;
-        double operator()() const;
+        // Evaluates the function at each point of the Cartesian product of the `axes`, without materializing it.
+        // The points are numbered with the last axis varying fastest, and the result of the i-th point
+        // is written to `out[i]`. Each argument must be swept by an axis, the first one if several have its name,
+        // while the axes of no argument repeat the results.
+        // The last axes are evaluated like the rows of the batch evaluation, for at least 2 KiB of results at a time
+        // and less than twice that, the first of them being split into tiles when it is long,
+        // while the parts of the expression depending only on the other axes are evaluated once
+        // whenever one of the axes they depend on takes its next value.
+        // The results may differ from the single `evaluate` in the last bit like those of the batch `evaluate`.
+        void sweep(std::span<const SweepAxis> axes, T* out) const;
+        // Same, but passes the results to `consume` tile by tile, in order of the points
+        void sweep(std::span<const SweepAxis> axes, const SweepConsumer& consume) const;
+        [[nodiscard]] Expected<void> try_sweep(std::span<const SweepAxis> axes, T* out) const;
+        [[nodiscard]] Expected<void> try_sweep(std::span<const SweepAxis> axes, const SweepConsumer& consume) const;
+
+        // A copy of the function with the `bound` arguments replaced by their values
+        // and the operations on numbers only, e.g. `2 * a` with `a` bound, computed once.
+        // A selection whose condition is computed keeps only its selected branch.
+        // The copy takes the arguments left in the same order, without those only used by a dropped branch.
+        // The values of the names which are not arguments are ignored.
+        // The operators are assumed to always give the same result for the same operand,
+        // like the memoization does, and the infix and postfix of the copy are those of the function.
+        // With `CompileOptions::share_programs`, the copies of the same shape share their program too.
+        [[nodiscard]] BasicFunction specialize(const Args& bound) const;
+
+        T operator()(const Args& args) const;
+        T operator()() const;
     
         const std::string& infix() const;
         const std::string& postfix() const;
 
+        // Names of the arguments in the order of their first occurrence in the expression
+        const std::vector<std::string_view>& arguments() const;
+
+        // Counters of the evaluations made while the instrumentation is enabled.
+        // Always zero unless the library is built with `POLISHD_INSTRUMENTATION`.
+        [[nodiscard]] instrumentation::EvaluationStats evaluation_stats() const;
+        void reset_evaluation_stats() const;
+
+        // Number of compiled units of each `TokenType`
+        [[nodiscard]] std::array<size_t, TokenTypeCount> unit_histogram() const;
+
+        // Whether both functions run the same program, i.e. have the same shape and only differ in their numbers
+        // and argument names. Always true for copies, otherwise only with `CompileOptions::share_programs`.
+        [[nodiscard]] bool shares_program_with(const BasicFunction& other) const;
+
     private:
-        using Stack = std::stack<double>;
+        using Grammar = BasicGrammar<T>;
+        using Stack = std::stack<T>;
+        using Clock = std::chrono::steady_clock;
+        // A unit of the expression while it is compiled and rewritten.
+        // On x64 the union takes 8 bytes (16 for `long double`) but `TokenType` takes 1 byte,
+        // so a Unit takes 16 bytes due to padding and the function keeps a compact `Program` instead.
         struct Unit {
-            // On x64
-            // The union takes 8 bytes
-            // But `TokenType` takes 1 byte
-            // So the whole Unit structure takes 16 bytes instead of 9 due to padding (multiples of 8)
             TokenType type;
             union {
-                double number;
-                Grammar::Unary unary;
-                Grammar::Binary binary;
+                T number;
+                typename Grammar::Unary unary;
+                typename Grammar::Binary binary;
                 size_t arg_index;
+                // Index of the next unit for `Condition` if it is false, and for `Alternative`
+                size_t jump;
+                // Integer exponent of `Power`
+                int exponent;
+                // Index of the operator in `m_stateful`
+                size_t stateful;
+                // Owned by the grammar while compiling, then shared by the function
+                const BasicMemoizedOperator<T>* memo;
             };
         };
         using UnitList = std::forward_list<Unit>;
         using Expression = std::vector<Unit>;
+
+        // The shape of the expression as a dense stream of 1-byte opcodes and a parallel stream of 2-byte operands,
+        // i.e. 3 bytes per unit. The operand of a unit is, depending on its type,
+        // the index of its number in the numbers of the function or of its operator in the tables below,
+        // the argument index, the jump target, the exponent or the index of the stateful operator.
+        // Each distinct operator is stored once, however many times it occurs,
+        // along with its vectorized kernel for the batch evaluation if it is a standard operator.
+        // Immutable once assembled, so that the functions of the same shape may share it.
+        struct Program
+        {
+            std::vector<TokenType> opcodes;
+            std::vector<uint16_t> operands;
+            std::vector<typename Grammar::Unary> unary;
+            std::vector<typename Grammar::Binary> binary;
+            std::vector<kernels::UnaryKernel<T>> unary_kernels;
+            std::vector<kernels::BinaryKernel<T>> binary_kernels;
+            // Null if there is no `MultiplyAdd` unit or no kernel for it
+            kernels::TernaryKernel<T> multiply_add_kernel = nullptr;
+            std::vector<std::shared_ptr<const BasicMemoizedOperator<T>>> memos;
+
+            bool operator==(const Program& other) const = default;
+        };
+
+        // Longest expression a `Program` can address
+        static constexpr size_t MaxUnits = std::numeric_limits<uint16_t>::max();
+
+        // Number of rows evaluated per step of the batch evaluation.
+        // Each stack slot gets a 2KiB buffer, i.e. 256 doubles or 512 floats,
+        // so a few slots comfortably fit into L1 cache
+        // and narrower types get proportionally more SIMD lanes per step.
+        static constexpr size_t BatchSize = 2048 / sizeof(T);
+        // Least number of rows for a thread of `reduce` to be worth spawning
+        static constexpr size_t MinRowsPerThread = 64 * BatchSize;
     
-        explicit Function(Expression expression,
-                          const std::unordered_map<std::string_view, size_t>& arg_indices,
-                          const std::string& infix,
-                          std::string postfix);
+        using Stateful = typename Grammar::Stateful;
+
+        // A stateful operator and the offset of its state in the state of the whole function
+        struct StatefulUnit
+        {
+            Stateful op;
+            size_t offset;
+        };
+
+        // Buffers of the batch evaluation,
+        // kept between the calls by a `BasicStreamEvaluator` along with the state
+        struct Workspace
+        {
+            std::vector<T> scratch;
+            std::vector<const T*> slots;
+            std::vector<std::byte> state;
+            // A column for each number of the program, if the rows are functions sharing it
+            std::vector<const T*> number_columns = {};
+        };
+
+        explicit BasicFunction(Expression expression,
+                               const std::unordered_map<std::string_view, size_t>& arg_indices,
+                               const std::string& infix,
+                               std::string postfix,
+                               std::vector<Stateful> stateful = {},
+                               bool share_program = false);
+
+        // The infix expression along with the argument names pointing into it.
+        // Copying and moving keep the names pointing into their own `infix`.
+        struct Source
+        {
+            std::string infix;
+            std::vector<std::string_view> arg_names;
+
+            Source(const std::string& infix, const std::unordered_map<std::string_view, size_t>& arg_indices);
+            Source(const Source& other);
+            Source(Source&& other) noexcept;
+            Source& operator=(const Source& other);
+            Source& operator=(Source&& other) noexcept;
+
+        private:
+            void rebase(const char* other_infix);
+        };
+
+        template<bool Profiled>
+        T run(std::span<const T> arg_values, instrumentation::UnitProfile* profile) const;
+        // Passes the results of each step of up to `BatchSize` rows to `consume(values, offset, n)`
+        template<bool Profiled, typename Consume>
+        void run(const std::vector<const T*>& arg_columns, size_t count, Workspace& workspace,
+                 instrumentation::UnitProfile* profile, Consume&& consume) const;
+        // The batch evaluation for `BasicStreamEvaluator`, profiled if `profile` is not null
+        void run_stream(const std::vector<const T*>& arg_columns, T* out, size_t count,
+                        Workspace& workspace, instrumentation::UnitProfile* profile) const;
+        [[nodiscard]] Workspace make_workspace() const;
+        void init_state(std::byte* state) const;
+        // `x ^ n` by squaring, i.e. in at most 2 * log2(|n|) multiplications
+        static T power(T x, int n);
+        // `power` of `n` values, a step of the squarings at a time
+        static void power(const T* x, T* out, size_t n, int exponent);
+        static void profile_unit(instrumentation::UnitProfile& profile, TokenType type, Clock::time_point start);
+
+        // Replaces the bound arguments of the subtree at `index` by their values, see `specialize`,
+        // and computes the operations on numbers.
+        // Returns the subtree replacing it, either itself or the selected branch of a selection.
+        static size_t bind(BasicExpressionTree<T>& tree, size_t index, const std::vector<std::optional<T>>& arg_values);
+        static size_t stack_depth_of(const Expression& expression);
+        // Moves the numbers of the expression to `numbers`
+        static Program assemble(const Expression& expression, std::vector<T>& numbers);
+        // The program of the same shape assembled before if any function still holds it, otherwise `program`
+        static std::shared_ptr<const Program> intern(Program program);
+        static size_t hash_of(const Program& program);
+        // The expression the `Program` was assembled from
+        [[nodiscard]] Expression disassemble() const;
+        Expected<std::vector<const T*>> resolve_columns(const Columns& columns) const;
+        Error missing_argument(std::string_view arg_name) const;
     private:
-        Expression m_expression;
-        std::vector<std::string_view> m_arg_names;
-        std::string m_infix;
+        std::shared_ptr<const Program> m_program;
+        // Whether `m_program` is interned, so that the copies made by `specialize` are too
+        bool m_shared_program = false;
+        std::vector<T> m_numbers;
+        size_t m_stack_depth;
+        std::vector<StatefulUnit> m_stateful;
+        size_t m_state_size = 0;
+        Source m_source;
         std::string m_postfix;
+#ifdef POLISHD_INSTRUMENTATION
+        mutable instrumentation::Counters m_counters;
+#endif
     };
 
+    extern template class BasicFunction<float>;
+    extern template class BasicFunction<double>;
+    extern template class BasicFunction<long double>;
+
+    using Function = BasicFunction<double>;
+
 } // namespace polishd
 
 #endif //INC_POLISHD_FUNCTION_HPP
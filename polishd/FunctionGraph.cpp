@@ -0,0 +1,313 @@
+#include <FunctionGraph.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+#include <exceptions.hpp>
+
+namespace polishd {
+
+    template<typename T>
+    void BasicFunctionGraph<T>::add(const std::string& name, Function function)
+    {
+        m_functions.insert_or_assign(name, std::move(function));
+        m_linked = false;
+    }
+
+    template<typename T>
+    void BasicFunctionGraph<T>::remove(std::string_view name)
+    {
+        if (const auto lookup = m_functions.find(name); lookup != m_functions.end())
+        {
+            m_functions.erase(lookup);
+            m_linked = false;
+        }
+    }
+
+    template<typename T>
+    bool BasicFunctionGraph<T>::contains(std::string_view name) const
+    {
+        return m_functions.contains(name);
+    }
+
+    template<typename T>
+    void BasicFunctionGraph<T>::set(std::string_view input, T value)
+    {
+        if (m_functions.contains(input))
+            throw FunctionGraphError("'" + std::string(input) + "' is a formula, not an input");
+        Input& slot = m_inputs[input_index(input)];
+        if (slot.set && same(slot.value, value))
+            return;
+        slot.value = value;
+        slot.set = true;
+        if (m_linked)
+        {
+            for (const size_t dependent: slot.dependents)
+                schedule(dependent);
+        }
+    }
+
+    template<typename T>
+    void BasicFunctionGraph<T>::set(const Args& inputs)
+    {
+        for (const auto& [name, value]: inputs)
+            set(name, value);
+    }
+
+    template<typename T>
+    void BasicFunctionGraph<T>::update(size_t threads)
+    {
+        if (!m_linked)
+            link();
+        m_recomputed = 0;
+        std::vector<T> results;
+        // recomputing a formula may only schedule the formulas of the higher levels
+        for (size_t level = 0; level < m_pending.size(); ++level)
+        {
+            std::vector<size_t>& pending = m_pending[level];
+            if (pending.empty())
+                continue;
+            for (const size_t index: pending)
+            {
+                for (const Source& source: m_nodes[index].sources)
+                {
+                    if (source.is_input && !m_inputs[source.index].set)
+                        throw FunctionGraphError("the input '" + m_inputs[source.index].name + "' of '"
+                                                 + std::string(m_nodes[index].name) + "' is not set");
+                }
+            }
+            results.resize(pending.size());
+            evaluate_level(pending, results, threads);
+            for (size_t i = 0; i < pending.size(); ++i)
+            {
+                Node& node = m_nodes[pending[i]];
+                node.pending = false;
+                if (same(node.value, results[i]))
+                    continue;
+                node.value = results[i];
+                for (const size_t dependent: node.dependents)
+                    schedule(dependent);
+            }
+            m_recomputed += pending.size();
+            pending.clear();
+        }
+    }
+
+    template<typename T>
+    T BasicFunctionGraph<T>::value(std::string_view name) const
+    {
+        if (const auto lookup = m_node_indices.find(name); lookup != m_node_indices.end())
+            return m_nodes[lookup->second].value;
+        if (const auto lookup = m_input_indices.find(name); lookup != m_input_indices.end())
+            return m_inputs[lookup->second].value;
+        throw FunctionGraphError("no formula or input '" + std::string(name) + "'");
+    }
+
+    template<typename T>
+    std::vector<std::string_view> BasicFunctionGraph<T>::order()
+    {
+        if (!m_linked)
+            link();
+        std::vector<std::string_view> names;
+        names.reserve(m_nodes.size());
+        for (const Node& node: m_nodes)
+            names.push_back(node.name);
+        return names;
+    }
+
+    template<typename T>
+    size_t BasicFunctionGraph<T>::recomputed() const
+    {
+        return m_recomputed;
+    }
+
+    template<typename T>
+    void BasicFunctionGraph<T>::link()
+    {
+        std::vector<Node> nodes;
+        nodes.reserve(m_functions.size());
+        TransparentStringKeyMap<size_t> indices;
+        for (const auto& [name, function]: m_functions)
+        {
+            indices.emplace(name, nodes.size());
+            nodes.push_back({.name = name, .function = &function});
+        }
+        for (Input& input: m_inputs)
+            input.dependents.clear();
+        for (Node& node: nodes)
+        {
+            for (const std::string_view argument: node.function->arguments())
+            {
+                if (const auto lookup = indices.find(argument); lookup != indices.end())
+                    node.sources.push_back({.is_input = false, .index = lookup->second});
+                else
+                    node.sources.push_back({.is_input = true, .index = input_index(argument)});
+            }
+        }
+
+        // Kahn's algorithm, the formulas left with dependencies are on a cycle or depend on one
+        std::vector<size_t> in_degrees(nodes.size(), 0);
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            for (const Source& source: nodes[i].sources)
+            {
+                if (!source.is_input)
+                {
+                    ++in_degrees[i];
+                    nodes[source.index].dependents.push_back(i);
+                }
+            }
+        }
+        std::vector<size_t> order;
+        order.reserve(nodes.size());
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            if (in_degrees[i] == 0)
+                order.push_back(i);
+        }
+        for (size_t k = 0; k < order.size(); ++k)
+        {
+            for (const size_t dependent: nodes[order[k]].dependents)
+            {
+                if (--in_degrees[dependent] == 0)
+                    order.push_back(dependent);
+            }
+        }
+        if (order.size() < nodes.size())
+            throw_cycle(nodes, in_degrees);
+
+        // renumber the formulas in topological order, so that the sources precede them
+        std::vector<size_t> positions(nodes.size());
+        for (size_t k = 0; k < order.size(); ++k)
+            positions[order[k]] = k;
+        m_nodes.clear();
+        m_nodes.reserve(nodes.size());
+        m_node_indices.clear();
+        for (const size_t i: order)
+        {
+            const size_t k = m_nodes.size();
+            Node& node = m_nodes.emplace_back(Node {.name = nodes[i].name, .function = nodes[i].function});
+            node.sources = std::move(nodes[i].sources);
+            for (Source& source: node.sources)
+            {
+                if (source.is_input)
+                {
+                    m_inputs[source.index].dependents.push_back(k);
+                    continue;
+                }
+                source.index = positions[source.index];
+                m_nodes[source.index].dependents.push_back(k);
+                node.level = std::max(node.level, m_nodes[source.index].level + 1);
+            }
+            m_node_indices.emplace(node.name, k);
+        }
+
+        size_t levels = 0;
+        for (const Node& node: m_nodes)
+            levels = std::max(levels, node.level + 1);
+        m_pending.assign(levels, {});
+        m_linked = true;
+        for (size_t k = 0; k < m_nodes.size(); ++k)
+            schedule(k);
+    }
+
+    template<typename T>
+    void BasicFunctionGraph<T>::schedule(size_t node)
+    {
+        Node& scheduled = m_nodes[node];
+        if (scheduled.pending)
+            return;
+        scheduled.pending = true;
+        m_pending[scheduled.level].push_back(node);
+    }
+
+    template<typename T>
+    void BasicFunctionGraph<T>::evaluate_level(const std::vector<size_t>& level, std::vector<T>& results, size_t threads) const
+    {
+        const size_t workers = std::clamp<size_t>(level.size() / MinNodesPerThread, 1, std::max<size_t>(threads, 1));
+        std::vector<std::exception_ptr> failures(workers);
+        const auto evaluate_range = [&](size_t worker)
+        {
+            try
+            {
+                std::vector<T> arg_values;
+                const size_t end = level.size() * (worker + 1) / workers;
+                for (size_t i = level.size() * worker / workers; i < end; ++i)
+                    results[i] = evaluate_node(m_nodes[level[i]], arg_values);
+            }
+            catch (...)
+            {
+                failures[worker] = std::current_exception();
+            }
+        };
+        {
+            std::vector<std::jthread> helpers;
+            helpers.reserve(workers - 1);
+            for (size_t worker = 1; worker < workers; ++worker)
+                helpers.emplace_back(evaluate_range, worker);
+            evaluate_range(0);
+        }
+        for (const std::exception_ptr& failure: failures)
+        {
+            if (failure)
+                std::rethrow_exception(failure);
+        }
+    }
+
+    template<typename T>
+    T BasicFunctionGraph<T>::evaluate_node(const Node& node, std::vector<T>& arg_values) const
+    {
+        arg_values.clear();
+        for (const Source& source: node.sources)
+            arg_values.push_back(source.is_input ? m_inputs[source.index].value : m_nodes[source.index].value);
+        return node.function->evaluate(std::span<const T>(arg_values));
+    }
+
+    template<typename T>
+    size_t BasicFunctionGraph<T>::input_index(std::string_view name)
+    {
+        if (const auto lookup = m_input_indices.find(name); lookup != m_input_indices.end())
+            return lookup->second;
+        m_input_indices.emplace(std::string(name), m_inputs.size());
+        m_inputs.push_back({.name = std::string(name)});
+        return m_inputs.size() - 1;
+    }
+
+    template<typename T>
+    bool BasicFunctionGraph<T>::same(T a, T b)
+    {
+        return a == b || (a != a && b != b);
+    }
+
+    template<typename T>
+    void BasicFunctionGraph<T>::throw_cycle(const std::vector<Node>& nodes, const std::vector<size_t>& in_degrees)
+    {
+        // every formula left has a source left, so following them must come back to a formula seen before
+        std::vector<size_t> path;
+        std::vector<size_t> positions(nodes.size(), nodes.size());
+        size_t current = std::find_if(in_degrees.begin(), in_degrees.end(), [](size_t d) { return d > 0; }) - in_degrees.begin();
+        while (positions[current] == nodes.size())
+        {
+            positions[current] = path.size();
+            path.push_back(current);
+            for (const Source& source: nodes[current].sources)
+            {
+                if (!source.is_input && in_degrees[source.index] > 0)
+                {
+                    current = source.index;
+                    break;
+                }
+            }
+        }
+        std::string cycle;
+        for (size_t k = positions[current]; k < path.size(); ++k)
+            cycle += std::string(nodes[path[k]].name) + " -> ";
+        throw FunctionGraphError("the formulas depend on each other in a cycle: " + cycle + std::string(nodes[current].name));
+    }
+
+    template class BasicFunctionGraph<float>;
+    template class BasicFunctionGraph<double>;
+    template class BasicFunctionGraph<long double>;
+
+} // namespace polishd
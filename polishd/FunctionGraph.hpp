@@ -0,0 +1,117 @@
+#ifndef INC_POLISHD_FUNCTION_GRAPH_HPP
+#define INC_POLISHD_FUNCTION_GRAPH_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+#include <TransparentStringKeyMap.hpp>
+#include <Function.hpp>
+
+namespace polishd {
+
+    // Named functions, i.e. formulas, whose arguments are either inputs or the values of other formulas,
+    // recomputed incrementally like the cells of a spreadsheet.
+    // Not thread-safe: `update` is the only member that evaluates, and it may use threads on its own.
+    template<typename T>
+    class BasicFunctionGraph
+    {
+    public:
+        using Function = BasicFunction<T>;
+        using Args = BasicArgs<T>;
+
+        // Adds or replaces the formula `name`.
+        // Its arguments named like other formulas read their values, the others are inputs.
+        void add(const std::string& name, Function function);
+        void remove(std::string_view name);
+        [[nodiscard]] bool contains(std::string_view name) const;
+
+        // Sets an input, the formulas depending on it are recomputed by the next `update`
+        void set(std::string_view input, T value);
+        void set(const Args& inputs);
+
+        // Recomputes the formulas affected by the changes since the last update, level by level,
+        // where the level of a formula is the length of the longest chain of formulas it depends on.
+        // A formula whose value did not change does not trigger the formulas depending on it.
+        // Formulas of the same level are independent and are evaluated on up to `threads` threads.
+        // Throws `FunctionGraphError` on a dependency cycle or an input which was never set,
+        // and the exceptions of `Function::evaluate`.
+        void update(size_t threads = 1);
+
+        // The value of a formula as of the last `update`, or of an input
+        [[nodiscard]] T value(std::string_view name) const;
+
+        // The formulas in an order where each comes after the formulas it depends on.
+        // Throws `FunctionGraphError` on a dependency cycle.
+        [[nodiscard]] std::vector<std::string_view> order();
+
+        // Number of formulas evaluated by the last `update`
+        [[nodiscard]] size_t recomputed() const;
+
+    private:
+        // An argument of a formula, either the value of a formula or an input
+        struct Source
+        {
+            bool is_input;
+            size_t index;
+        };
+
+        struct Node
+        {
+            std::string_view name;
+            const Function* function = nullptr;
+            std::vector<Source> sources = {};
+            // Formulas reading the value, once per argument
+            std::vector<size_t> dependents = {};
+            size_t level = 0;
+            T value = T(0);
+            // Scheduled for the next `update`
+            bool pending = false;
+        };
+
+        struct Input
+        {
+            std::string name;
+            T value = T(0);
+            bool set = false;
+            std::vector<size_t> dependents = {};
+        };
+
+        // Least number of formulas of a level for each thread to be worth spawning
+        static constexpr size_t MinNodesPerThread = 64;
+
+        // Resolves the arguments, sorts the formulas and schedules all of them
+        void link();
+        void schedule(size_t node);
+        void evaluate_level(const std::vector<size_t>& level, std::vector<T>& results, size_t threads) const;
+        T evaluate_node(const Node& node, std::vector<T>& arg_values) const;
+        size_t input_index(std::string_view name);
+        // Whether `a` and `b` are the same value, NaN included
+        static bool same(T a, T b);
+        [[noreturn]] static void throw_cycle(const std::vector<Node>& nodes, const std::vector<size_t>& in_degrees);
+
+    private:
+        TransparentStringKeyMap<Function> m_functions;
+        // Kept when the formulas change, so that the values set before stay
+        std::vector<Input> m_inputs;
+        TransparentStringKeyMap<size_t> m_input_indices;
+
+        // The formulas in topological order along with the pending ones of each level,
+        // valid while `m_linked`
+        bool m_linked = false;
+        std::vector<Node> m_nodes;
+        TransparentStringKeyMap<size_t> m_node_indices;
+        std::vector<std::vector<size_t>> m_pending;
+        size_t m_recomputed = 0;
+    };
+
+    extern template class BasicFunctionGraph<float>;
+    extern template class BasicFunctionGraph<double>;
+    extern template class BasicFunctionGraph<long double>;
+
+    using FunctionGraph = BasicFunctionGraph<double>;
+
+} // namespace polishd
+
+#endif // INC_POLISHD_FUNCTION_GRAPH_HPP
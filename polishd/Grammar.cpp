@@ -1,48 +1,86 @@
 #include <Grammar.hpp>
 
+#include <algorithm>
+
 namespace polishd {
 
-    const TransparentStringKeyMap<double>& Grammar::constants() const
+    template<typename T>
+    const TransparentStringKeyMap<T>& BasicGrammar<T>::constants() const
     {
         return m_constants;
     }
 
-    const TransparentStringKeyMap<Grammar::Unary>& Grammar::prefix() const
+    template<typename T>
+    const TransparentStringKeyMap<typename BasicGrammar<T>::Unary>& BasicGrammar<T>::prefix() const
     {
         return m_prefix_operators;
     }
 
-    const TransparentStringKeyMap<Grammar::BinaryOperator>& Grammar::binary() const
+    template<typename T>
+    const TransparentStringKeyMap<typename BasicGrammar<T>::BinaryOperator>& BasicGrammar<T>::binary() const
     {
         return m_binary_operators;
     }
 
-    const TransparentStringKeyMap<Grammar::Unary>& Grammar::postfix() const
+    template<typename T>
+    const TransparentStringKeyMap<typename BasicGrammar<T>::Unary>& BasicGrammar<T>::postfix() const
     {
         return m_postfix_operators;
     }
 
-    void Grammar::add_constant(const std::string& name, double value)
+    template<typename T>
+    const TransparentStringKeyMap<typename BasicGrammar<T>::Stateful>& BasicGrammar<T>::stateful() const
+    {
+        return m_stateful_operators;
+    }
+
+    template<typename T>
+    const TransparentStringKeyMap<std::shared_ptr<const typename BasicGrammar<T>::Memoized>>& BasicGrammar<T>::memoized() const
+    {
+        return m_memoized_operators;
+    }
+
+    template<typename T>
+    void BasicGrammar<T>::add_constant(const std::string& name, T value)
     {
         m_constants.insert_or_assign(name, value);
     }
 
-    void Grammar::add_prefix_operator(const std::string& signature, Unary prefix)
+    template<typename T>
+    void BasicGrammar<T>::add_prefix_operator(const std::string& signature, Unary prefix)
     {
         m_prefix_operators.insert_or_assign(signature, prefix);
+        m_memoized_operators.erase(signature);
     }
 
-    void Grammar::add_binary_operator(const std::string& signature, Binary binary, Precedence precedence)
+    template<typename T>
+    void BasicGrammar<T>::add_memoized_prefix_operator(const std::string& signature, Unary prefix, size_t slots)
     {
-        m_binary_operators.insert_or_assign(signature, BinaryOperator {binary, precedence});
+        m_prefix_operators.insert_or_assign(signature, prefix);
+        m_memoized_operators.insert_or_assign(signature, std::make_shared<const Memoized>(prefix, slots));
+    }
+
+    template<typename T>
+    void BasicGrammar<T>::add_binary_operator(const std::string& signature, Binary binary, Precedence precedence,
+                                              Arithmetic arithmetic)
+    {
+        m_binary_operators.insert_or_assign(signature, BinaryOperator {binary, precedence, arithmetic});
     }
 
-    void Grammar::add_postfix_operator(const std::string& signature, Unary postfix)
+    template<typename T>
+    void BasicGrammar<T>::add_postfix_operator(const std::string& signature, Unary postfix)
     {
         m_postfix_operators.insert_or_assign(signature, postfix);
     }
 
-    size_t Grammar::match_number(const std::string& s, size_t start)
+    template<typename T>
+    void BasicGrammar<T>::add_stateful_operator(const std::string& signature, const Stateful& stateful)
+    {
+        m_stateful_operators.insert_or_assign(signature, stateful);
+    }
+
+    template<typename T>
+    size_t BasicGrammar<T>::match_number(const std::string& s, size_t start)
     {
         const bool is_signed = (s[start] == '-' || s[start] == '+');
         size_t end = start + is_signed;
@@ -54,7 +92,8 @@ namespace polishd {
         return (end - start) * (!is_signed || (end - start) > 1);
     }
 
-    size_t Grammar::match_argument(const std::string& s, size_t start)
+    template<typename T>
+    size_t BasicGrammar<T>::match_argument(const std::string& s, size_t start)
     {
         size_t end = start;
         while (end < s.size() && (isalpha(s[end]) || s[end] == '_'))
@@ -62,36 +101,69 @@ namespace polishd {
         return end - start;
     }
 
-    size_t Grammar::match_prefix(const std::string& s, size_t start) const
+    template<typename T>
+    size_t BasicGrammar<T>::match_prefix(const std::string& s, size_t start) const
     {
-        return match(s, start, m_prefix_operators);
+        return std::max(match(s, start, m_prefix_operators), match(s, start, m_stateful_operators));
     }
 
-    size_t Grammar::match_binary(const std::string& s, size_t start) const
+    template<typename T>
+    size_t BasicGrammar<T>::match_binary(const std::string& s, size_t start) const
     {
         return match(s, start, m_binary_operators);
     }
 
-    size_t Grammar::match_postfix(const std::string& s, size_t start) const
+    template<typename T>
+    size_t BasicGrammar<T>::match_postfix(const std::string& s, size_t start) const
     {
         return match(s, start, m_postfix_operators);
     }
 
+    template<typename T>
     template<typename Operator>
-    size_t Grammar::match(const std::string& s, size_t start, const TransparentStringKeyMap<Operator>& ops)
+    size_t BasicGrammar<T>::match(const std::string& s, size_t start, const TransparentStringKeyMap<Operator>& ops)
     {
+        // the longest signature wins, so that e.g. `<=` is not matched as `<`
+        size_t longest = 0;
         for (const auto& pair: ops)
         {
-            if (s.compare(start, pair.first.length(), pair.first) == 0)
-                return pair.first.length();
+            if (pair.first.length() > longest && s.compare(start, pair.first.length(), pair.first) == 0)
+                longest = pair.first.length();
         }
-        return 0;
+        return longest;
     }
 
-    Grammar::Precedence Grammar::precedence_of(std::string_view signature) const
+    template<typename T>
+    typename BasicGrammar<T>::Precedence BasicGrammar<T>::precedence_of(std::string_view signature) const
     {
         const auto lookup = m_binary_operators.find(signature);
         return lookup != m_binary_operators.end() ? lookup->second.precedence : 0;
     }
 
+    template<typename T>
+    typename BasicGrammar<T>::Binary BasicGrammar<T>::arithmetic_operator(Arithmetic arithmetic) const
+    {
+        for (const auto& [signature, op]: m_binary_operators)
+        {
+            if (op.arithmetic == arithmetic)
+                return op.binary;
+        }
+        return nullptr;
+    }
+
+    template<typename T>
+    Arithmetic BasicGrammar<T>::arithmetic_of(Binary binary) const
+    {
+        for (const auto& [signature, op]: m_binary_operators)
+        {
+            if (op.binary == binary && op.arithmetic != Arithmetic::None)
+                return op.arithmetic;
+        }
+        return Arithmetic::None;
+    }
+
+    template class BasicGrammar<float>;
+    template class BasicGrammar<double>;
+    template class BasicGrammar<long double>;
+
 } // namespace polishd
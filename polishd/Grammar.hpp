@@ -3,37 +3,69 @@
 
 #include <string>
 #include <string_view>
+#include <memory>
 
 #include <TransparentStringKeyMap.hpp>
+#include <StatefulOperator.hpp>
+#include <MemoizedOperator.hpp>
 
 namespace polishd {
 
-    class Grammar
+    // Marks a binary operator as the standard arithmetic operation,
+    // which allows the compiler to rewrite the expressions using it
+    enum class Arithmetic : unsigned char
     {
-        friend class CompilingContext;
+        None = 0,
+        Add,
+        Subtract,
+        Multiply,
+        Divide,
+        Power
+    };
+
+    // A set of constants and operators on the scalar type `T`,
+    // i.e. `float`, `double` or `long double`
+    template<typename T>
+    class BasicGrammar
+    {
+        template<typename> friend class BasicCompilingContext;
 
     public:
-        typedef double (* Unary)(double);
-        typedef double (* Binary)(double, double);
+        using Scalar = T;
+        typedef T (* Unary)(T);
+        typedef T (* Binary)(T, T);
         
+        using Stateful = BasicStatefulOperator<T>;
+        using Memoized = BasicMemoizedOperator<T>;
+
         using Precedence = unsigned char;
         
         struct BinaryOperator
         {
             Binary binary = nullptr;
             Precedence precedence = 0;
+            Arithmetic arithmetic = Arithmetic::None;
         };
 
     public:
-        [[nodiscard]] const TransparentStringKeyMap<double>& constants() const;
+        [[nodiscard]] const TransparentStringKeyMap<T>& constants() const;
         [[nodiscard]] const TransparentStringKeyMap<Unary>& prefix() const;
         [[nodiscard]] const TransparentStringKeyMap<BinaryOperator>& binary() const;
         [[nodiscard]] const TransparentStringKeyMap<Unary>& postfix() const;
+        [[nodiscard]] const TransparentStringKeyMap<Stateful>& stateful() const;
+        // The caches of the memoized prefix operators along with their hit counters
+        [[nodiscard]] const TransparentStringKeyMap<std::shared_ptr<const Memoized>>& memoized() const;
         
-        void add_constant(const std::string& name, double value);
+        void add_constant(const std::string& name, T value);
         void add_prefix_operator(const std::string& signature, Unary prefix);
-        void add_binary_operator(const std::string& signature, Binary binary, Precedence precedence);
+        // A prefix operator with a cache of `slots` results, for the expensive pure functions.
+        // The functions compiled with the operator share the cache.
+        void add_memoized_prefix_operator(const std::string& signature, Unary prefix, size_t slots = 256);
+        void add_binary_operator(const std::string& signature, Binary binary, Precedence precedence,
+                                 Arithmetic arithmetic = Arithmetic::None);
         void add_postfix_operator(const std::string& signature, Unary postfix);
+        // Used as a prefix operator, e.g. `avg(x)`
+        void add_stateful_operator(const std::string& signature, const Stateful& stateful);
         
     private:
         static size_t match_number(const std::string& s, size_t start);
@@ -46,14 +78,29 @@ namespace polishd {
         static size_t match(const std::string& s, size_t start, const TransparentStringKeyMap<Operator>& ops);
 
         Precedence precedence_of(std::string_view signature) const;
+
+    public:
+        // The function of the first binary operator marked with `arithmetic`, if any
+        [[nodiscard]] Binary arithmetic_operator(Arithmetic arithmetic) const;
+        // How the binary function is marked, if it is
+        [[nodiscard]] Arithmetic arithmetic_of(Binary binary) const;
         
     private:
-        TransparentStringKeyMap<double> m_constants;
+        TransparentStringKeyMap<T> m_constants;
         TransparentStringKeyMap<Unary> m_prefix_operators;
         TransparentStringKeyMap<BinaryOperator> m_binary_operators;
         TransparentStringKeyMap<Unary> m_postfix_operators;
+        TransparentStringKeyMap<Stateful> m_stateful_operators;
+        // Memoization of the entries of `m_prefix_operators`
+        TransparentStringKeyMap<std::shared_ptr<const Memoized>> m_memoized_operators;
     };
 
+    extern template class BasicGrammar<float>;
+    extern template class BasicGrammar<double>;
+    extern template class BasicGrammar<long double>;
+
+    using Grammar = BasicGrammar<double>;
+
 } // namespace polishd
 
 #endif //INC_POLISHD_GRAMMAR_HPP
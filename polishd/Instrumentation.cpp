@@ -0,0 +1,140 @@
+#include <Instrumentation.hpp>
+
+#include <mutex>
+
+namespace polishd::instrumentation {
+
+#ifdef POLISHD_INSTRUMENTATION
+    namespace detail {
+        std::atomic<bool> g_enabled {false};
+    }
+#endif
+
+    namespace {
+
+        std::atomic<uint32_t> g_sampling_period {0};
+        std::atomic<CompileHook> g_compile_hook {nullptr};
+
+        std::mutex g_compile_stats_mutex;
+        CompileStats g_compile_stats;
+
+        void add(std::atomic<uint64_t>& counter, uint64_t value)
+        {
+            counter.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        uint64_t load(const std::atomic<uint64_t>& counter)
+        {
+            return counter.load(std::memory_order_relaxed);
+        }
+
+    }
+
+    void enable([[maybe_unused]] bool enabled)
+    {
+#ifdef POLISHD_INSTRUMENTATION
+        detail::g_enabled.store(enabled, std::memory_order_relaxed);
+#endif
+    }
+
+    void set_sampling_period(uint32_t period)
+    {
+        g_sampling_period.store(period, std::memory_order_relaxed);
+    }
+
+    uint32_t sampling_period()
+    {
+        return g_sampling_period.load(std::memory_order_relaxed);
+    }
+
+    CompileStats compile_stats()
+    {
+        const std::lock_guard lock(g_compile_stats_mutex);
+        return g_compile_stats;
+    }
+
+    void reset_compile_stats()
+    {
+        const std::lock_guard lock(g_compile_stats_mutex);
+        g_compile_stats = {};
+    }
+
+    void set_compile_hook(CompileHook hook)
+    {
+        g_compile_hook.store(hook, std::memory_order_relaxed);
+    }
+
+    void record(const CompileStats& stats)
+    {
+        {
+            const std::lock_guard lock(g_compile_stats_mutex);
+            g_compile_stats.compilations += stats.compilations;
+            g_compile_stats.failures += stats.failures;
+            g_compile_stats.tokens += stats.tokens;
+            g_compile_stats.units += stats.units;
+            g_compile_stats.tokenize += stats.tokenize;
+            g_compile_stats.shunting_yard += stats.shunting_yard;
+            g_compile_stats.codegen += stats.codegen;
+        }
+        if (const CompileHook hook = g_compile_hook.load(std::memory_order_relaxed))
+            hook(stats);
+    }
+
+    Counters::Counters(const Counters& other)
+    {
+        *this = other;
+    }
+
+    Counters& Counters::operator=(const Counters& other)
+    {
+        if (this == &other)
+            return *this;
+        m_evaluations.store(load(other.m_evaluations), std::memory_order_relaxed);
+        m_rows.store(load(other.m_rows), std::memory_order_relaxed);
+        m_sampled.store(load(other.m_sampled), std::memory_order_relaxed);
+        for (size_t i = 0; i < TokenTypeCount; ++i)
+        {
+            m_counts[i].store(load(other.m_counts[i]), std::memory_order_relaxed);
+            m_nanoseconds[i].store(load(other.m_nanoseconds[i]), std::memory_order_relaxed);
+        }
+        return *this;
+    }
+
+    bool Counters::count(uint64_t rows)
+    {
+        const uint64_t evaluation = m_evaluations.fetch_add(1, std::memory_order_relaxed);
+        add(m_rows, rows);
+        const uint32_t period = sampling_period();
+        return period && evaluation % period == 0;
+    }
+
+    void Counters::record(const UnitProfile& profile)
+    {
+        add(m_sampled, 1);
+        for (size_t i = 0; i < TokenTypeCount; ++i)
+        {
+            add(m_counts[i], profile.counts[i]);
+            add(m_nanoseconds[i], static_cast<uint64_t>(profile.time[i].count()));
+        }
+    }
+
+    EvaluationStats Counters::snapshot() const
+    {
+        EvaluationStats stats;
+        stats.evaluations = load(m_evaluations);
+        stats.rows = load(m_rows);
+        stats.sampled = load(m_sampled);
+        for (size_t i = 0; i < TokenTypeCount; ++i)
+        {
+            stats.profile.counts[i] = load(m_counts[i]);
+            stats.profile.time[i] = std::chrono::nanoseconds(load(m_nanoseconds[i]));
+        }
+        return stats;
+    }
+
+    void Counters::reset()
+    {
+        *this = Counters();
+    }
+
+} // namespace polishd::instrumentation
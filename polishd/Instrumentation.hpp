@@ -0,0 +1,146 @@
+#ifndef INC_POLISHD_INSTRUMENTATION_HPP
+#define INC_POLISHD_INSTRUMENTATION_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <Token.hpp>
+
+// The instrumentation is compiled in only if `POLISHD_INSTRUMENTATION` is defined,
+// i.e. if the library is configured with `-DPOLISHD_INSTRUMENTATION=ON`.
+// Otherwise the functions below are no-ops and all the statistics stay zero.
+// When compiled in, it is still disabled until `enable()` is called,
+// and costs a single branch per compilation or evaluation while disabled.
+
+namespace polishd::instrumentation {
+
+#ifdef POLISHD_INSTRUMENTATION
+    constexpr bool available = true;
+#else
+    constexpr bool available = false;
+#endif
+
+    struct CompileStats
+    {
+        uint64_t compilations = 0;
+        // Compilations which returned an error, counted in `compilations` too
+        uint64_t failures = 0;
+        // Tokens of the infix expression, including parentheses
+        uint64_t tokens = 0;
+        // Units of the compiled functions, after the rewrites of the optimizer
+        uint64_t units = 0;
+        std::chrono::nanoseconds tokenize {0};
+        std::chrono::nanoseconds shunting_yard {0};
+        std::chrono::nanoseconds codegen {0};
+    };
+
+    // Executed units and the time spent in them, indexed by `TokenType`
+    struct UnitProfile
+    {
+        std::array<uint64_t, TokenTypeCount> counts {};
+        std::array<std::chrono::nanoseconds, TokenTypeCount> time {};
+    };
+
+    struct EvaluationStats
+    {
+        // Calls of `evaluate`, both scalar and batch
+        uint64_t evaluations = 0;
+        // Rows evaluated in total, a scalar evaluation counts as a single row
+        uint64_t rows = 0;
+        // Evaluations that were profiled per unit
+        uint64_t sampled = 0;
+        UnitProfile profile;
+    };
+
+    using CompileHook = void (*)(const CompileStats& stats);
+
+    void enable(bool enabled = true);
+
+    // Every `period`-th evaluation of each `Function` is profiled per unit.
+    // Timing each unit is expensive, so the profiling is off (`0`) by default.
+    void set_sampling_period(uint32_t period);
+    uint32_t sampling_period();
+
+    // Totals over all compilations since the last reset
+    CompileStats compile_stats();
+    void reset_compile_stats();
+
+    // Called with the statistics of every single compilation
+    void set_compile_hook(CompileHook hook);
+
+    void record(const CompileStats& stats);
+
+    // Per-`Function` evaluation counters.
+    // Copying a `Function` copies the current values.
+    class Counters
+    {
+    public:
+        Counters() = default;
+        Counters(const Counters& other);
+        Counters& operator=(const Counters& other);
+
+        // Returns whether this evaluation should be profiled
+        bool count(uint64_t rows);
+        void record(const UnitProfile& profile);
+
+        [[nodiscard]] EvaluationStats snapshot() const;
+        void reset();
+
+    private:
+        std::atomic<uint64_t> m_evaluations {0};
+        std::atomic<uint64_t> m_rows {0};
+        std::atomic<uint64_t> m_sampled {0};
+        std::array<std::atomic<uint64_t>, TokenTypeCount> m_counts {};
+        std::array<std::atomic<uint64_t>, TokenTypeCount> m_nanoseconds {};
+    };
+
+#ifdef POLISHD_INSTRUMENTATION
+    namespace detail {
+        extern std::atomic<bool> g_enabled;
+    }
+
+    // The only check made on the hot paths
+    inline bool enabled()
+    {
+        return detail::g_enabled.load(std::memory_order_relaxed);
+    }
+#else
+    inline bool enabled()
+    {
+        return false;
+    }
+#endif
+
+    // Adds the time from its construction to its destruction to `total`,
+    // or does nothing if `total` is null, e.g. while the instrumentation is disabled
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(std::chrono::nanoseconds* total)
+            : m_total(total)
+        {
+            if (m_total) [[unlikely]]
+                m_start = Clock::now();
+        }
+
+        ~ScopedTimer()
+        {
+            if (m_total) [[unlikely]]
+                *m_total += Clock::now() - m_start;
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        std::chrono::nanoseconds* m_total;
+        Clock::time_point m_start;
+    };
+
+} // namespace polishd::instrumentation
+
+#endif // INC_POLISHD_INSTRUMENTATION_HPP
@@ -0,0 +1,601 @@
+#include <Kernels.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+// Compiled with `-ffp-contract=off`, as the error-free transformations below rely on every product being rounded,
+// with `-fno-math-errno`, so that `std::sqrt` may be vectorized,
+// and with `-fno-trapping-math`, so that the range checks may be vectorized as blends.
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define POLISHD_X86_KERNELS
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define POLISHD_INLINE [[gnu::always_inline]] inline
+#else
+#define POLISHD_INLINE inline
+#endif
+
+namespace polishd::kernels {
+
+    template<typename T> T negate(T x) { return -x; }
+    template<typename T> T exp(T x) { return std::exp(x); }
+    template<typename T> T log(T x) { return std::log(x); }
+    template<typename T> T sin(T x) { return std::sin(x); }
+    template<typename T> T cos(T x) { return std::cos(x); }
+    template<typename T> T sqrt(T x) { return std::sqrt(x); }
+    template<typename T> T floor(T x) { return std::floor(x); }
+    template<typename T> T ceil(T x) { return std::ceil(x); }
+    template<typename T> T round(T x) { return std::round(x); }
+    template<typename T> T abs(T x) { return std::abs(x); }
+    template<typename T> T add(T a, T b) { return a + b; }
+    template<typename T> T subtract(T a, T b) { return a - b; }
+    template<typename T> T multiply(T a, T b) { return a * b; }
+    template<typename T> T divide(T a, T b) { return a / b; }
+    template<typename T> T pow(T a, T b) { return std::pow(a, b); }
+    template<typename T> T less(T a, T b) { return a < b; }
+    template<typename T> T greater(T a, T b) { return a > b; }
+    template<typename T> T less_equal(T a, T b) { return a <= b; }
+    template<typename T> T greater_equal(T a, T b) { return a >= b; }
+    template<typename T> T multiply_add(T a, T b, T c) { return std::fma(a, b, c); }
+
+    namespace
+    {
+
+        POLISHD_INLINE uint64_t bits_of(double x)
+        {
+            return std::bit_cast<uint64_t>(x);
+        }
+
+        POLISHD_INLINE double double_of(uint64_t bits)
+        {
+            return std::bit_cast<double>(bits);
+        }
+
+        constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+        constexpr double MinNormal = std::numeric_limits<double>::min();
+        constexpr double Max = std::numeric_limits<double>::max();
+        // Adding it rounds a number below 2^51 to an integer, which ends up in the low bits of the sum
+        constexpr double Shifter = 0x1.8p52;
+
+        constexpr double Log2e = 0x1.71547652b82fep0;
+        // ln(2) split so that its multiples by up to 11 bits integers are exact
+        constexpr double Ln2Hi = 0x1.62e42fee00000p-1;
+        constexpr double Ln2Lo = 0x1.a39ef35793c76p-33;
+        constexpr double Sqrt2 = 0x1.6a09e667f3bcdp0;
+        constexpr double TwoThirdsHi = 0x1.5555555555555p-1;
+        constexpr double TwoThirdsLo = 0x1.5555555555555p-55;
+        constexpr double TwoOverPi = 0x1.45f306dc9c883p-1;
+        // pi/2 split so that its multiples by up to 20 bits integers are exact but for the last part
+        constexpr double PiOver2A = 0x1.921fb54400000p0;
+        constexpr double PiOver2B = 0x1.0b4611a600000p-34;
+        constexpr double PiOver2C = 0x1.3198a2e000000p-69;
+        constexpr double PiOver2D = 0x1.b839a252049c1p-104;
+        // Largest argument of `sin` and `cos` reduced in double-double precision
+        constexpr double MaxTrigonometric = 0x1p20 * 1.5707963267948966;
+        // Below it `sin(x)` rounds to `x`, which the standard library gets right for the signed zeros too
+        constexpr double MinSine = 0x1p-27;
+
+        // Error-free transformations, `hi` is the rounded result and `lo` its rounding error
+        POLISHD_INLINE void two_sum(double a, double b, double& hi, double& lo)
+        {
+            hi = a + b;
+            const double b_rounded = hi - a;
+            lo = (a - (hi - b_rounded)) + (b - b_rounded);
+        }
+
+        // Requires |a| >= |b|
+        POLISHD_INLINE void fast_two_sum(double a, double b, double& hi, double& lo)
+        {
+            hi = a + b;
+            lo = b - (hi - a);
+        }
+
+        // Dekker's product, as fused multiply-adds are not there on every instruction set
+        POLISHD_INLINE void two_product(double a, double b, double& hi, double& lo)
+        {
+            constexpr double Splitter = 0x1p27 + 1;
+            const double ta = Splitter * a;
+            const double a_hi = ta - (ta - a);
+            const double a_lo = a - a_hi;
+            const double tb = Splitter * b;
+            const double b_hi = tb - (tb - b);
+            const double b_lo = b - b_hi;
+            hi = a * b;
+            lo = ((a_hi * b_hi - hi) + a_hi * b_lo + a_lo * b_hi) + a_lo * b_lo;
+        }
+
+        // e^(x + dx) for |dx| much less than 1, NaN out of [-707, 709] where the result would not be normal
+        POLISHD_INLINE double exp_core(double x, double dx)
+        {
+            // x = n ln(2) + r with |r| <= ln(2) / 2, where x - n ln(2)_hi is exact
+            const double shifted = x * Log2e + Shifter;
+            const double n = shifted - Shifter;
+            const double r_hi = x - n * Ln2Hi;
+            const double r_lo = dx - n * Ln2Lo;
+            const double r = r_hi + r_lo;
+            // Taylor series, its 14th term is below 2^-56
+            const double q = r * r * (1.0 / 2 + r * (1.0 / 6 + r * (1.0 / 24 + r * (1.0 / 120 + r * (1.0 / 720
+                           + r * (1.0 / 5040 + r * (1.0 / 40320 + r * (1.0 / 362880 + r * (1.0 / 3628800
+                           + r * (1.0 / 39916800 + r * (1.0 / 479001600 + r * (1.0 / 6227020800))))))))))));
+            // rounded once, 1 + r_hi is exact as hi + lo
+            double hi, lo;
+            two_sum(1, r_hi, hi, lo);
+            const double p = hi + (lo + (r_lo + q));
+            // adds n to the exponent, the low bits of `shifted` are n
+            const double result = double_of(bits_of(p) + (bits_of(shifted) << 52));
+            return (x >= -707) & (x <= 709) ? result : NaN;
+        }
+
+        // x = 2^e (1 + f) with 1 + f in [sqrt(2)/2, sqrt(2)), for x positive and normal
+        POLISHD_INLINE void log_reduce(double x, double& e, double& f)
+        {
+            const uint64_t bits = bits_of(x);
+            const double biased = double_of(0x4330000000000000ull | (bits >> 52)) - 0x1p52;
+            const double m = double_of((bits & 0x000FFFFFFFFFFFFFull) | 0x3FF0000000000000ull);
+            const bool above = m >= Sqrt2;
+            e = biased - (above ? 1022 : 1023);
+            f = (above ? m * 0.5 : m) - 1;
+        }
+
+        // log(x), NaN unless x is positive, normal and finite
+        POLISHD_INLINE double log_core(double x)
+        {
+            double e, f;
+            log_reduce(x, e, f);
+            // log(1 + f) = 2 atanh(s) = 2s + s R(s^2) = f - s (f - R(s^2)), |s| < 0.172
+            const double s = f / (2 + f);
+            const double z = s * s;
+            const double R = z * (2.0 / 3 + z * (2.0 / 5 + z * (2.0 / 7 + z * (2.0 / 9 + z * (2.0 / 11
+                           + z * (2.0 / 13 + z * (2.0 / 15 + z * (2.0 / 17 + z * (2.0 / 19 + z * (2.0 / 21))))))))));
+            // the rounding error of e ln(2) + f is added back with the small terms
+            double hi, lo;
+            two_sum(e * Ln2Hi, f, hi, lo);
+            const double result = hi + (lo + (e * Ln2Lo - s * (f - R)));
+            return (x >= MinNormal) & (x <= Max) ? result : NaN;
+        }
+
+        // log(x) as hi + lo to about 2^-68 of an absolute error for x positive, normal and finite,
+        // so that the rounding errors of log(x) do not grow into the large powers
+        POLISHD_INLINE void log_double_double(double x, double& hi, double& lo)
+        {
+            double e, f;
+            log_reduce(x, e, f);
+            // s = f / (2 + f)
+            double u_hi, u_lo;
+            fast_two_sum(2, f, u_hi, u_lo);
+            const double s_hi = f / u_hi;
+            double p_hi, p_lo;
+            two_product(s_hi, u_hi, p_hi, p_lo);
+            const double s_lo = (((f - p_hi) - p_lo) - s_hi * u_lo) / u_hi;
+            // R(z) = 2/3 z + z^2 (2/5 + 2/7 z + ...), only its leading term needs the extra precision
+            double z_hi, z_lo;
+            two_product(s_hi, s_hi, z_hi, z_lo);
+            z_lo += 2 * s_hi * s_lo;
+            double t_hi, t_lo;
+            two_product(TwoThirdsHi, z_hi, t_hi, t_lo);
+            t_lo += TwoThirdsHi * z_lo + TwoThirdsLo * z_hi;
+            // two more terms than `log_core`, the next one is below 2^-72
+            const double rest = z_hi * z_hi * (2.0 / 5 + z_hi * (2.0 / 7 + z_hi * (2.0 / 9 + z_hi * (2.0 / 11
+                              + z_hi * (2.0 / 13 + z_hi * (2.0 / 15 + z_hi * (2.0 / 17 + z_hi * (2.0 / 19
+                              + z_hi * (2.0 / 21 + z_hi * (2.0 / 23 + z_hi * (2.0 / 25)))))))))));
+            double r_hi, r_lo;
+            fast_two_sum(t_hi, rest, r_hi, r_lo);
+            r_lo += t_lo;
+            double sr_hi, sr_lo;
+            two_product(s_hi, r_hi, sr_hi, sr_lo);
+            sr_lo += s_hi * r_lo + s_lo * r_hi;
+            // e ln(2) + 2s + s R(s^2)
+            double a_hi, a_lo, b_hi, b_lo;
+            two_sum(e * Ln2Hi, 2 * s_hi, a_hi, a_lo);
+            two_sum(a_hi, sr_hi, b_hi, b_lo);
+            fast_two_sum(b_hi, (a_lo + b_lo) + ((2 * s_lo + sr_lo) + e * Ln2Lo), hi, lo);
+        }
+
+        // a^b, NaN unless a is positive, normal and finite and the result is normal
+        POLISHD_INLINE double pow_core(double a, double b)
+        {
+            double l_hi, l_lo;
+            log_double_double(a, l_hi, l_lo);
+            double p_hi, p_lo;
+            two_product(b, l_hi, p_hi, p_lo);
+            p_lo += b * l_lo;
+            const double result = exp_core(p_hi, p_lo);
+            // the splitting of a larger `b` could overflow
+            return (a >= MinNormal) & (a <= Max) & (std::abs(b) <= 0x1p900) ? result : NaN;
+        }
+
+        // sin(x) for the quadrant 0 and cos(x) for the quadrant 1 and so on,
+        // NaN out of [-1.6e6, 1.6e6] and between -2^-27 and 2^-27
+        POLISHD_INLINE double sin_cos_core(double x, uint64_t quadrant)
+        {
+            // x = n pi/2 + r with |r| <= pi/4 and r = r_hi + r_lo
+            const double shifted = x * TwoOverPi + Shifter;
+            const double n = shifted - Shifter;
+            double r_hi, r_lo, c_hi, c_lo;
+            two_sum(x - n * PiOver2A, -(n * PiOver2B), r_hi, r_lo);
+            two_sum(r_hi, -(n * PiOver2C), c_hi, c_lo);
+            fast_two_sum(c_hi, (r_lo + c_lo) - n * PiOver2D, r_hi, r_lo);
+            // Taylor series, their next terms are below 2^-60
+            const double z = r_hi * r_hi;
+            const double sin_tail = z * (-1.0 / 6 + z * (1.0 / 120 + z * (-1.0 / 5040 + z * (1.0 / 362880
+                                  + z * (-1.0 / 39916800 + z * (1.0 / 6227020800 + z * (-1.0 / 1307674368000
+                                  + z * (1.0 / 355687428096000))))))));
+            // sin(r_hi + r_lo) = sin(r_hi) + r_lo cos(r_hi)
+            const double sine = r_hi + (r_hi * sin_tail + r_lo * (1 - 0.5 * z));
+            const double cos_tail = z * z * (1.0 / 24 + z * (-1.0 / 720 + z * (1.0 / 40320 + z * (-1.0 / 3628800
+                                  + z * (1.0 / 479001600 + z * (-1.0 / 87178291200 + z * (1.0 / 20922789888000
+                                  + z * (-1.0 / 6402373705728000))))))));
+            // cos(r_hi + r_lo) = cos(r_hi) - r_lo sin(r_hi), with the rounding error of 1 - z/2 added back
+            const double half_z = 0.5 * z;
+            const double w = 1 - half_z;
+            const double cosine = w + (((1 - w) - half_z) + (cos_tail - r_hi * r_lo));
+            // blended with masks, SSE2 cannot compare 64 bits integers
+            const uint64_t q = bits_of(shifted) + quadrant;
+            const uint64_t odd = 0 - (q & 1);
+            const uint64_t chosen = (bits_of(cosine) & odd) | (bits_of(sine) & ~odd);
+            const double result = double_of(chosen ^ ((q & 2) << 62));
+            const double magnitude = std::abs(x);
+            return (magnitude >= MinSine) & (magnitude <= MaxTrigonometric) ? result : NaN;
+        }
+
+        struct Exp
+        {
+            POLISHD_INLINE static double core(double x) { return exp_core(x, 0); }
+            template<typename T> static T fallback(T x) { return std::exp(x); }
+        };
+
+        struct Log
+        {
+            POLISHD_INLINE static double core(double x) { return log_core(x); }
+            template<typename T> static T fallback(T x) { return std::log(x); }
+        };
+
+        struct Sin
+        {
+            POLISHD_INLINE static double core(double x) { return sin_cos_core(x, 0); }
+            template<typename T> static T fallback(T x) { return std::sin(x); }
+        };
+
+        struct Cos
+        {
+            POLISHD_INLINE static double core(double x) { return sin_cos_core(x, 1); }
+            template<typename T> static T fallback(T x) { return std::cos(x); }
+        };
+
+        struct Pow
+        {
+            POLISHD_INLINE static double core(double a, double b) { return pow_core(a, b); }
+            template<typename T> static T fallback(T a, T b) { return std::pow(a, b); }
+        };
+
+        // The kernels written out for every value, exact as they are
+        struct Negate { template<typename T> static T apply(T x) { return -x; } };
+        struct Sqrt { template<typename T> static T apply(T x) { return std::sqrt(x); } };
+        struct Floor { template<typename T> static T apply(T x) { return std::floor(x); } };
+        struct Ceil { template<typename T> static T apply(T x) { return std::ceil(x); } };
+        struct Abs { template<typename T> static T apply(T x) { return std::abs(x); } };
+        struct Add { template<typename T> static T apply(T a, T b) { return a + b; } };
+        struct Subtract { template<typename T> static T apply(T a, T b) { return a - b; } };
+        struct Multiply { template<typename T> static T apply(T a, T b) { return a * b; } };
+        struct Divide { template<typename T> static T apply(T a, T b) { return a / b; } };
+        struct Less { template<typename T> static T apply(T a, T b) { return a < b; } };
+        struct Greater { template<typename T> static T apply(T a, T b) { return a > b; } };
+        struct LessEqual { template<typename T> static T apply(T a, T b) { return a <= b; } };
+        struct GreaterEqual { template<typename T> static T apply(T a, T b) { return a >= b; } };
+        struct MultiplyAdd { template<typename T> static T apply(T a, T b, T c) { return std::fma(a, b, c); } };
+
+        // Half away from zero like `std::round`, which the compilers do not vectorize
+        struct Round
+        {
+            template<typename T>
+            static T apply(T x)
+            {
+                const T truncated = std::trunc(x);
+                return truncated + std::copysign(std::abs(x - truncated) >= T(0.5) ? T(1) : T(0), x);
+            }
+        };
+
+        // Number of values approximated before the ones out of range fall back to the standard library,
+        // all of them first so that the loops are vectorized, and then the output is written
+        // so that it may be the input
+        constexpr size_t Block = 64;
+
+        template<typename Op, typename T>
+        POLISHD_INLINE void approximate(const T* x, T* out, size_t n)
+        {
+            double results[Block];
+            for (size_t offset = 0; offset < n; offset += Block)
+            {
+                const size_t m = std::min(Block, n - offset);
+                for (size_t i = 0; i < m; ++i)
+                    results[i] = Op::core(static_cast<double>(x[offset + i]));
+                for (size_t i = 0; i < m; ++i)
+                {
+                    if (results[i] != results[i])
+                        results[i] = Op::fallback(x[offset + i]);
+                }
+                for (size_t i = 0; i < m; ++i)
+                    out[offset + i] = static_cast<T>(results[i]);
+            }
+        }
+
+        template<typename Op, typename T>
+        POLISHD_INLINE void approximate(const T* a, const T* b, T* out, size_t n)
+        {
+            double results[Block];
+            for (size_t offset = 0; offset < n; offset += Block)
+            {
+                const size_t m = std::min(Block, n - offset);
+                for (size_t i = 0; i < m; ++i)
+                    results[i] = Op::core(static_cast<double>(a[offset + i]), static_cast<double>(b[offset + i]));
+                for (size_t i = 0; i < m; ++i)
+                {
+                    if (results[i] != results[i])
+                        results[i] = Op::fallback(a[offset + i], b[offset + i]);
+                }
+                for (size_t i = 0; i < m; ++i)
+                    out[offset + i] = static_cast<T>(results[i]);
+            }
+        }
+
+        template<typename T>
+        struct UnaryEntry
+        {
+            Unary<T> scalar;
+            UnaryKernel<T> kernel;
+        };
+
+        template<typename T>
+        struct BinaryEntry
+        {
+            Binary<T> scalar;
+            BinaryKernel<T> kernel;
+        };
+
+        template<typename T>
+        struct Table
+        {
+            std::array<UnaryEntry<T>, 10> unary;
+            std::array<BinaryEntry<T>, 9> binary;
+            TernaryKernel<T> multiply_add;
+        };
+
+// The kernels compiled for an instruction set, the inlined cores included
+#define POLISHD_KERNEL_SET(isa, attributes, pow_kernel, multiply_add_kernel)                        \
+        namespace isa                                                                               \
+        {                                                                                           \
+            template<typename Op, typename T>                                                       \
+            attributes void approximated(const T* x, T* out, size_t n)                              \
+            {                                                                                       \
+                approximate<Op>(x, out, n);                                                         \
+            }                                                                                       \
+                                                                                                    \
+            template<typename Op, typename T>                                                       \
+            attributes void approximated(const T* a, const T* b, T* out, size_t n)                  \
+            {                                                                                       \
+                approximate<Op>(a, b, out, n);                                                      \
+            }                                                                                       \
+                                                                                                    \
+            template<typename Op, typename T>                                                       \
+            attributes void exact(const T* x, T* out, size_t n)                                     \
+            {                                                                                       \
+                for (size_t i = 0; i < n; ++i)                                                      \
+                    out[i] = Op::apply(x[i]);                                                       \
+            }                                                                                       \
+                                                                                                    \
+            template<typename Op, typename T>                                                       \
+            attributes void exact(const T* a, const T* b, T* out, size_t n)                         \
+            {                                                                                       \
+                for (size_t i = 0; i < n; ++i)                                                      \
+                    out[i] = Op::apply(a[i], b[i]);                                                 \
+            }                                                                                       \
+                                                                                                    \
+            template<typename Op, typename T>                                                       \
+            attributes void exact(const T* a, const T* b, const T* c, T* out, size_t n)             \
+            {                                                                                       \
+                for (size_t i = 0; i < n; ++i)                                                      \
+                    out[i] = Op::apply(a[i], b[i], c[i]);                                           \
+            }                                                                                       \
+                                                                                                    \
+            template<typename T>                                                                    \
+            Table<T> table()                                                                        \
+            {                                                                                       \
+                return {                                                                            \
+                    .unary = {{                                                                     \
+                        {&kernels::negate<T>, &exact<Negate, T>},                                   \
+                        {&kernels::exp<T>, &approximated<Exp, T>},                                  \
+                        {&kernels::log<T>, &approximated<Log, T>},                                  \
+                        {&kernels::sin<T>, &approximated<Sin, T>},                                  \
+                        {&kernels::cos<T>, &approximated<Cos, T>},                                  \
+                        {&kernels::sqrt<T>, &exact<Sqrt, T>},                                       \
+                        {&kernels::floor<T>, &exact<Floor, T>},                                     \
+                        {&kernels::ceil<T>, &exact<Ceil, T>},                                       \
+                        {&kernels::round<T>, &exact<Round, T>},                                     \
+                        {&kernels::abs<T>, &exact<Abs, T>}                                          \
+                    }},                                                                             \
+                    .binary = {{                                                                    \
+                        {&kernels::add<T>, &exact<Add, T>},                                         \
+                        {&kernels::subtract<T>, &exact<Subtract, T>},                               \
+                        {&kernels::multiply<T>, &exact<Multiply, T>},                               \
+                        {&kernels::divide<T>, &exact<Divide, T>},                                   \
+                        {&kernels::pow<T>, pow_kernel},                                             \
+                        {&kernels::less<T>, &exact<Less, T>},                                       \
+                        {&kernels::greater<T>, &exact<Greater, T>},                                 \
+                        {&kernels::less_equal<T>, &exact<LessEqual, T>},                            \
+                        {&kernels::greater_equal<T>, &exact<GreaterEqual, T>}                       \
+                    }},                                                                             \
+                    .multiply_add = multiply_add_kernel                                             \
+                };                                                                                  \
+            }                                                                                       \
+        }
+
+        // SSE2 is the baseline of x86-64.
+        // Its 2 lanes do not make up for the products of `pow` split without fused multiply-adds,
+        // so the standard library is faster there, and it has no fused multiply-add for `multiply_add` either.
+        // The fused multiply-adds of the other sets are only used by `multiply_add`, as `-ffp-contract=off`
+        // keeps the other kernels from contracting.
+        POLISHD_KERNEL_SET(baseline, , nullptr, nullptr)
+#ifdef POLISHD_X86_KERNELS
+        POLISHD_KERNEL_SET(avx2, [[gnu::target("avx2,fma")]], (&approximated<Pow, T>), (&exact<MultiplyAdd, T>))
+        POLISHD_KERNEL_SET(avx512, [[gnu::target("avx512f,avx512dq,prefer-vector-width=512")]], (&approximated<Pow, T>),
+                           (&exact<MultiplyAdd, T>))
+#endif
+
+#undef POLISHD_KERNEL_SET
+
+        enum class InstructionSet
+        {
+            Baseline,
+            Avx2,
+            Avx512
+        };
+
+        InstructionSet detect()
+        {
+            InstructionSet supported = InstructionSet::Baseline;
+#ifdef POLISHD_X86_KERNELS
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq"))
+                supported = InstructionSet::Avx512;
+            else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+                supported = InstructionSet::Avx2;
+#endif
+            if (const char* cap = std::getenv("POLISHD_ISA"))
+            {
+                const std::string_view name = cap;
+                if (name == "sse2" || name == "generic")
+                    supported = InstructionSet::Baseline;
+                else if (name == "avx2")
+                    supported = std::min(supported, InstructionSet::Avx2);
+            }
+            return supported;
+        }
+
+        InstructionSet instruction_set_in_use()
+        {
+            static const InstructionSet instruction_set = detect();
+            return instruction_set;
+        }
+
+        template<typename T>
+        const Table<T>& table()
+        {
+            static const Table<T> table = []
+            {
+#ifdef POLISHD_X86_KERNELS
+                switch (instruction_set_in_use())
+                {
+                    case InstructionSet::Avx512:
+                        return avx512::table<T>();
+                    case InstructionSet::Avx2:
+                        return avx2::table<T>();
+                    default:
+                        break;
+                }
+#endif
+                return baseline::table<T>();
+            }();
+            return table;
+        }
+
+    } // namespace
+
+    template<typename T>
+    UnaryKernel<T> find(Unary<T> scalar)
+    {
+        if constexpr (std::is_same_v<T, long double>)
+            return nullptr;
+        else
+        {
+            for (const UnaryEntry<T>& entry: table<T>().unary)
+            {
+                if (entry.scalar == scalar)
+                    return entry.kernel;
+            }
+            return nullptr;
+        }
+    }
+
+    template<typename T>
+    BinaryKernel<T> find(Binary<T> scalar)
+    {
+        if constexpr (std::is_same_v<T, long double>)
+            return nullptr;
+        else
+        {
+            for (const BinaryEntry<T>& entry: table<T>().binary)
+            {
+                if (entry.scalar == scalar)
+                    return entry.kernel;
+            }
+            return nullptr;
+        }
+    }
+
+    template<typename T>
+    TernaryKernel<T> find(Ternary<T> scalar)
+    {
+        if constexpr (std::is_same_v<T, long double>)
+            return nullptr;
+        else
+            return scalar == &kernels::multiply_add<T> ? table<T>().multiply_add : nullptr;
+    }
+
+    const char* instruction_set()
+    {
+        switch (instruction_set_in_use())
+        {
+            case InstructionSet::Avx512:
+                return "avx512";
+            case InstructionSet::Avx2:
+                return "avx2";
+            default:
+#ifdef POLISHD_X86_KERNELS
+                return "sse2";
+#else
+                return "generic";
+#endif
+        }
+    }
+
+#define POLISHD_INSTANTIATE_KERNELS(T)                                          \
+    template T negate<T>(T);                                                    \
+    template T exp<T>(T);                                                       \
+    template T log<T>(T);                                                       \
+    template T sin<T>(T);                                                       \
+    template T cos<T>(T);                                                       \
+    template T sqrt<T>(T);                                                      \
+    template T floor<T>(T);                                                     \
+    template T ceil<T>(T);                                                      \
+    template T round<T>(T);                                                     \
+    template T abs<T>(T);                                                       \
+    template T add<T>(T, T);                                                    \
+    template T subtract<T>(T, T);                                               \
+    template T multiply<T>(T, T);                                               \
+    template T divide<T>(T, T);                                                 \
+    template T pow<T>(T, T);                                                    \
+    template T less<T>(T, T);                                                   \
+    template T greater<T>(T, T);                                                \
+    template T less_equal<T>(T, T);                                             \
+    template T greater_equal<T>(T, T);                                          \
+    template T multiply_add<T>(T, T, T);                                        \
+    template UnaryKernel<T> find<T>(Unary<T>);                                  \
+    template BinaryKernel<T> find<T>(Binary<T>);                                \
+    template TernaryKernel<T> find<T>(Ternary<T>);
+
+    POLISHD_INSTANTIATE_KERNELS(float)
+    POLISHD_INSTANTIATE_KERNELS(double)
+    POLISHD_INSTANTIATE_KERNELS(long double)
+
+#undef POLISHD_INSTANTIATE_KERNELS
+
+} // namespace polishd::kernels
@@ -0,0 +1,84 @@
+#ifndef INC_POLISHD_KERNELS_HPP
+#define INC_POLISHD_KERNELS_HPP
+
+#include <cstddef>
+
+namespace polishd::kernels {
+
+    template<typename T>
+    using Unary = T (*)(T);
+    template<typename T>
+    using Binary = T (*)(T, T);
+    template<typename T>
+    using Ternary = T (*)(T, T, T);
+
+    // Applies an operator to `n` values, `out` may be the same array as an input
+    template<typename T>
+    using UnaryKernel = void (*)(const T* x, T* out, size_t n);
+    template<typename T>
+    using BinaryKernel = void (*)(const T* a, const T* b, T* out, size_t n);
+    template<typename T>
+    using TernaryKernel = void (*)(const T* a, const T* b, const T* c, T* out, size_t n);
+
+    // The operators of `standard_grammar()`.
+    // A single evaluation calls them, i.e. the C++ standard library,
+    // while the batch evaluation calls their vectorized kernels found by `find`.
+    template<typename T> T negate(T x);
+    template<typename T> T exp(T x);
+    template<typename T> T log(T x);
+    template<typename T> T sin(T x);
+    template<typename T> T cos(T x);
+    template<typename T> T sqrt(T x);
+    template<typename T> T floor(T x);
+    template<typename T> T ceil(T x);
+    template<typename T> T round(T x);
+    template<typename T> T abs(T x);
+    template<typename T> T add(T a, T b);
+    template<typename T> T subtract(T a, T b);
+    template<typename T> T multiply(T a, T b);
+    template<typename T> T divide(T a, T b);
+    template<typename T> T pow(T a, T b);
+    template<typename T> T less(T a, T b);
+    template<typename T> T greater(T a, T b);
+    template<typename T> T less_equal(T a, T b);
+    template<typename T> T greater_equal(T a, T b);
+    // `a * b + c` rounded once, i.e. `std::fma`, which the compiler rewrites into, see `CompileOptions`
+    template<typename T> T multiply_add(T a, T b, T c);
+
+    // The kernel of one of the operators above, or null for any other operator and for `long double`.
+    //
+    // The kernels of `exp`, `log`, `sin`, `cos` and `pow` are polynomial approximations evaluated in double precision,
+    // for `float` too, and stay below 1 ULP of error.
+    // The largest errors `polishd_accuracy` (in `bench/`) measures for `double` over a million random arguments are:
+    //   exp  0.69 ULP
+    //   log  0.93 ULP
+    //   sin  0.78 ULP
+    //   cos  0.77 ULP
+    //   pow  0.80 ULP
+    // while the `float` results stay within 0.56 ULP.
+    // They differ from the standard library in the last bit for up to 4% of the `double` arguments
+    // and about 1% of the `float` ones.
+    // The arguments out of the range of an approximation, e.g. `sin` of more than 1.6e6 or `log` of a subnormal,
+    // along with the special values fall back to the standard library.
+    // The other kernels give exactly the results of their operators.
+    // Every instruction set gives the same results, as none of the kernels contracts to fused multiply-adds,
+    // but SSE2 has no kernel for `pow`, the standard library being faster there, nor for `multiply_add`.
+    template<typename T>
+    [[nodiscard]] UnaryKernel<T> find(Unary<T> scalar);
+    template<typename T>
+    [[nodiscard]] BinaryKernel<T> find(Binary<T> scalar);
+    // The kernel of `multiply_add` exists only with the fused multiply-add instructions of AVX2 and AVX-512,
+    // as `std::fma` is a call into the standard library without them.
+    // The batch evaluation then rounds the product before the sum, unlike a single evaluation.
+    template<typename T>
+    [[nodiscard]] TernaryKernel<T> find(Ternary<T> scalar);
+
+    // The instruction set the kernels were compiled for and picked on this CPU:
+    // "avx512", "avx2" (along with FMA), "sse2" or "generic" off x86.
+    // The environment variable `POLISHD_ISA` set to one of them caps the choice, e.g. to compare them;
+    // on x86 "generic" runs the SSE2 kernels all the same, as they are the baseline there.
+    [[nodiscard]] const char* instruction_set();
+
+} // namespace polishd::kernels
+
+#endif // INC_POLISHD_KERNELS_HPP
@@ -0,0 +1,147 @@
+#include <MemoizedOperator.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace polishd {
+
+    namespace {
+
+        // The stripe of the counters of the calling thread, the same for all operators
+        // Constant-initialized, as a thread_local with a dynamic initializer is checked on each access
+        std::atomic<size_t> g_next_thread {0};
+        thread_local size_t t_thread = std::numeric_limits<size_t>::max();
+
+        size_t counter_stripe(size_t stripes)
+        {
+            if (t_thread == std::numeric_limits<size_t>::max()) [[unlikely]]
+                t_thread = g_next_thread.fetch_add(1, std::memory_order_relaxed);
+            return t_thread % stripes;
+        }
+
+    }
+
+    template<typename T>
+    BasicMemoizedOperator<T>::BasicMemoizedOperator(Unary unary, size_t slots)
+        : m_unary(unary),
+          m_slot_count(std::bit_ceil(std::max<size_t>(slots, 2))),
+          m_shift(64 - std::countr_zero(m_slot_count)),
+          m_slots(std::make_unique<Slot[]>(m_slot_count))
+    {
+    }
+
+    template<typename T>
+    T BasicMemoizedOperator<T>::operator()(T x) const
+    {
+        const Bits key = bits_of(x);
+        Slot& slot = m_slots[slot_of(key)];
+        const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != 0 && sequence % 2 == 0)
+        {
+            Bits cached_key, cached_value;
+            for (size_t w = 0; w < Words; ++w)
+            {
+                cached_key[w] = slot.key[w].load(std::memory_order_relaxed);
+                cached_value[w] = slot.value[w].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (cached_key == key && slot.sequence.load(std::memory_order_relaxed) == sequence)
+            {
+                m_counters[counter_stripe(Stripes)].hits.fetch_add(1, std::memory_order_relaxed);
+                return value_of(cached_value);
+            }
+        }
+        m_counters[counter_stripe(Stripes)].misses.fetch_add(1, std::memory_order_relaxed);
+        const T result = m_unary(x);
+        store(slot, key, result);
+        return result;
+    }
+
+    template<typename T>
+    void BasicMemoizedOperator<T>::store(Slot& slot, const Bits& key, T result) const
+    {
+        uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+        if (sequence % 2 != 0 || !slot.sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_relaxed))
+            return;
+        // the odd sequence is visible before any of the new bits
+        std::atomic_thread_fence(std::memory_order_release);
+        const Bits value = bits_of(result);
+        for (size_t w = 0; w < Words; ++w)
+        {
+            slot.key[w].store(key[w], std::memory_order_relaxed);
+            slot.value[w].store(value[w], std::memory_order_relaxed);
+        }
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    template<typename T>
+    auto BasicMemoizedOperator<T>::bits_of(T x) -> Bits
+    {
+        Bits bits {};
+        std::memcpy(bits.data(), &x, ValueBytes);
+        return bits;
+    }
+
+    template<typename T>
+    T BasicMemoizedOperator<T>::value_of(const Bits& bits)
+    {
+        T x {};
+        std::memcpy(&x, bits.data(), ValueBytes);
+        return x;
+    }
+
+    template<typename T>
+    size_t BasicMemoizedOperator<T>::slot_of(const Bits& key) const
+    {
+        // the finalizer of SplitMix64, nearby arguments differ only in a few high bits of the mantissa
+        uint64_t hash = 0;
+        for (const uint64_t word: key)
+        {
+            hash ^= word;
+            hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+            hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+            hash ^= hash >> 31;
+        }
+        return static_cast<size_t>(hash >> m_shift);
+    }
+
+    template<typename T>
+    auto BasicMemoizedOperator<T>::unary() const -> Unary
+    {
+        return m_unary;
+    }
+
+    template<typename T>
+    size_t BasicMemoizedOperator<T>::slots() const
+    {
+        return m_slot_count;
+    }
+
+    template<typename T>
+    MemoStats BasicMemoizedOperator<T>::stats() const
+    {
+        MemoStats stats;
+        for (const Counters& counters: m_counters)
+        {
+            stats.hits += counters.hits.load(std::memory_order_relaxed);
+            stats.misses += counters.misses.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+    template<typename T>
+    void BasicMemoizedOperator<T>::reset_stats() const
+    {
+        for (Counters& counters: m_counters)
+        {
+            counters.hits.store(0, std::memory_order_relaxed);
+            counters.misses.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    template class BasicMemoizedOperator<float>;
+    template class BasicMemoizedOperator<double>;
+    template class BasicMemoizedOperator<long double>;
+
+} // namespace polishd
@@ -0,0 +1,93 @@
+#ifndef INC_POLISHD_MEMOIZED_OPERATOR_HPP
+#define INC_POLISHD_MEMOIZED_OPERATOR_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+namespace polishd {
+
+    // Calls of a memoized operator, counted since its creation or the last `reset_stats()`
+    struct MemoStats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+
+        // The share of the calls answered from the cache, 0 if there were none
+        [[nodiscard]] double hit_rate() const
+        {
+            const uint64_t calls = hits + misses;
+            return calls ? static_cast<double>(hits) / static_cast<double>(calls) : 0.0;
+        }
+    };
+
+    // A unary operator with a bounded cache of its results keyed on the bits of the argument.
+    // The cache is direct-mapped and shared by all threads without locks:
+    // each slot has a sequence number which is odd while the slot is written,
+    // a reader treats a slot that changed under it as a miss,
+    // and a writer leaves the slot alone if another thread is writing it.
+    template<typename T>
+    class BasicMemoizedOperator : public std::enable_shared_from_this<BasicMemoizedOperator<T>>
+    {
+    public:
+        typedef T (* Unary)(T);
+
+        // `slots` is rounded up to a power of two
+        BasicMemoizedOperator(Unary unary, size_t slots);
+
+        T operator()(T x) const;
+
+        [[nodiscard]] Unary unary() const;
+        [[nodiscard]] size_t slots() const;
+
+        [[nodiscard]] MemoStats stats() const;
+        void reset_stats() const;
+
+    private:
+        // x87 extended precision is padded with 6 bytes which are not a part of the value
+        static constexpr size_t ValueBytes = std::numeric_limits<T>::digits == 64 ? 10 : sizeof(T);
+        static constexpr size_t Words = (ValueBytes + 7) / 8;
+        using Bits = std::array<uint64_t, Words>;
+
+        struct Slot
+        {
+            // 0 until the slot is first written, odd while it is written
+            std::atomic<uint64_t> sequence {0};
+            std::array<std::atomic<uint64_t>, Words> key {};
+            std::array<std::atomic<uint64_t>, Words> value {};
+        };
+
+        static Bits bits_of(T x);
+        static T value_of(const Bits& bits);
+        size_t slot_of(const Bits& key) const;
+        void store(Slot& slot, const Bits& key, T result) const;
+
+    private:
+        Unary m_unary;
+        size_t m_slot_count;
+        // Bits of the hash selecting the slot
+        unsigned m_shift;
+        std::unique_ptr<Slot[]> m_slots;
+        // Every call updates the counters, so each thread counts on a cache line of its own,
+        // shared only if more than `Stripes` threads call the operator, and `stats()` sums them
+        static constexpr size_t Stripes = 16;
+        struct alignas(64) Counters
+        {
+            std::atomic<uint64_t> hits {0};
+            std::atomic<uint64_t> misses {0};
+        };
+        mutable std::array<Counters, Stripes> m_counters;
+    };
+
+    extern template class BasicMemoizedOperator<float>;
+    extern template class BasicMemoizedOperator<double>;
+    extern template class BasicMemoizedOperator<long double>;
+
+    using MemoizedOperator = BasicMemoizedOperator<double>;
+
+} // namespace polishd
+
+#endif // INC_POLISHD_MEMOIZED_OPERATOR_HPP
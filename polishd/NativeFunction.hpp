@@ -0,0 +1,28 @@
+#ifndef INC_POLISHD_NATIVE_FUNCTION_HPP
+#define INC_POLISHD_NATIVE_FUNCTION_HPP
+
+#include <span>
+#include <string_view>
+
+namespace polishd {
+
+    // An expression compiled ahead of time into C++ code by `BasicCodeGenerator`.
+    // The generated headers define a constant table of these, see `BasicRegistry`.
+    template<typename T>
+    struct BasicNativeFunction
+    {
+        using Evaluate = T (*)(const T* args);
+
+        std::string_view name;
+        // The expression the code was generated from
+        std::string_view infix;
+        // Takes the argument values in the order of `arguments`
+        Evaluate evaluate = nullptr;
+        std::span<const std::string_view> arguments;
+    };
+
+    using NativeFunction = BasicNativeFunction<double>;
+
+} // namespace polishd
+
+#endif // INC_POLISHD_NATIVE_FUNCTION_HPP
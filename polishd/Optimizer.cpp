@@ -0,0 +1,303 @@
+#include <Optimizer.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace polishd {
+
+    template<typename T>
+    BasicOptimizer<T>::BasicOptimizer(const Grammar& grammar)
+        : m_grammar(grammar),
+          m_add(grammar.arithmetic_operator(Arithmetic::Add)),
+          m_subtract(grammar.arithmetic_operator(Arithmetic::Subtract)),
+          m_multiply(grammar.arithmetic_operator(Arithmetic::Multiply))
+    {
+    }
+
+    template<typename T>
+    void BasicOptimizer<T>::optimize(Expression& expression) const
+    {
+        if (!has_arithmetic(expression))
+            return;
+        Tree tree(expression);
+        // polynomials are matched first, before their sums and products are fused
+        rewrite_polynomials(tree, tree.root());
+        rewrite_operations(tree, tree.root());
+        expression = tree.emit();
+    }
+
+    template<typename T>
+    bool BasicOptimizer<T>::has_arithmetic(const Expression& expression) const
+    {
+        return std::any_of(expression.begin(), expression.end(), [this](const auto& unit)
+        {
+            return unit.type == TokenType::Binary && m_grammar.arithmetic_of(unit.binary) != Arithmetic::None;
+        });
+    }
+
+    template<typename T>
+    void BasicOptimizer<T>::rewrite_polynomials(Tree& tree, size_t index) const
+    {
+        const Arithmetic arithmetic = arithmetic_of(tree.node(index));
+        if (arithmetic == Arithmetic::Add || arithmetic == Arithmetic::Subtract)
+        {
+            if (const std::optional<size_t> horner = rewrite_horner(tree, index))
+                tree.node(index) = tree.node(*horner);
+        }
+        const Node node = tree.node(index);
+        for (size_t i = 0; i < Tree::arity(node.unit.type); ++i)
+            rewrite_polynomials(tree, node.children[i]);
+    }
+
+    template<typename T>
+    void BasicOptimizer<T>::rewrite_operations(Tree& tree, size_t index) const
+    {
+        Node node = tree.node(index);
+        for (size_t i = 0; i < Tree::arity(node.unit.type); ++i)
+            rewrite_operations(tree, node.children[i]);
+
+        switch (arithmetic_of(node))
+        {
+            case Arithmetic::Power:
+            {
+                const std::optional<int> exponent = integer_exponent(tree.node(node.children[1]));
+                if (exponent && std::abs(*exponent) >= 2)
+                {
+                    node.unit = {.type = TokenType::Power, .exponent = *exponent};
+                    tree.node(index) = node;
+                }
+                break;
+            }
+            case Arithmetic::Add:
+            {
+                // a * b + c or c + a * b
+                for (size_t i = 0; i < 2; ++i)
+                {
+                    const Node& product = tree.node(node.children[i]);
+                    if (arithmetic_of(product) != Arithmetic::Multiply)
+                        continue;
+                    const size_t addend = node.children[1 - i];
+                    node.unit = {.type = TokenType::MultiplyAdd, .number = T(0)};
+                    node.children = {product.children[0], product.children[1], addend};
+                    tree.node(index) = node;
+                    break;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    template<typename T>
+    std::optional<size_t> BasicOptimizer<T>::rewrite_horner(Tree& tree, size_t index) const
+    {
+        std::vector<size_t> term_nodes;
+        std::vector<bool> signs;
+        collect_terms(tree, index, false, term_nodes, signs);
+        if (term_nodes.size() < 2 || !m_add || !m_multiply)
+            return std::nullopt;
+
+        // the variable is the argument of the highest degree among those found in a place of `x` or `x ^ n`,
+        // e.g. `x` and not `a` in `a * x ^ 3 + b * x ^ 2 + c * x + d`
+        std::vector<std::vector<size_t>> factors(term_nodes.size());
+        std::vector<size_t> candidates;
+        for (size_t i = 0; i < term_nodes.size(); ++i)
+        {
+            collect_factors(tree, term_nodes[i], factors[i]);
+            for (const size_t factor: factors[i])
+            {
+                const std::optional<size_t> argument = argument_of(tree, factor);
+                if (argument && std::find(candidates.begin(), candidates.end(), *argument) == candidates.end())
+                    candidates.push_back(*argument);
+            }
+        }
+
+        std::optional<size_t> x;
+        std::vector<Term> terms;
+        unsigned max_degree = 0;
+        for (const size_t candidate: candidates)
+        {
+            std::optional<std::vector<Term>> candidate_terms = polynomial_terms(tree, factors, signs, candidate);
+            if (!candidate_terms)
+                continue;
+            unsigned degree = 0;
+            for (const Term& term: *candidate_terms)
+                degree = std::max(degree, term.degree);
+            if (degree > max_degree && degree <= MaxExponent)
+            {
+                x = candidate;
+                terms = std::move(*candidate_terms);
+                max_degree = degree;
+            }
+        }
+        if (!x || max_degree < 2)
+            return std::nullopt;
+
+        std::vector<std::vector<const Term*>> by_degree(max_degree + 1);
+        for (const Term& term: terms)
+            by_degree[term.degree].push_back(&term);
+
+        // acc = acc * x + c, starting from the leading coefficient, where an implicit `1` is left out
+        const Node x_node {.unit = {.type = TokenType::Argument, .arg_index = *x}};
+        const auto& leading = by_degree[max_degree];
+        std::optional<size_t> result;
+        if (leading.size() > 1 || leading[0]->negative || !leading[0]->coefficient.empty())
+            result = build_coefficient(tree, leading);
+        for (unsigned degree = max_degree; degree-- > 0;)
+        {
+            const bool has_coefficient = !by_degree[degree].empty();
+            const size_t coefficient = has_coefficient ? build_coefficient(tree, by_degree[degree]) : 0;
+            if (!result)
+                result = has_coefficient ? binary(tree, m_add, tree.add(x_node), coefficient) : tree.add(x_node);
+            else if (!has_coefficient)
+                result = binary(tree, m_multiply, *result, tree.add(x_node));
+            else
+            {
+                Node multiply_add {.unit = {.type = TokenType::MultiplyAdd, .number = T(0)}};
+                multiply_add.children = {*result, tree.add(x_node), coefficient};
+                result = tree.add(multiply_add);
+            }
+        }
+        return *result;
+    }
+
+    template<typename T>
+    std::optional<std::vector<typename BasicOptimizer<T>::Term>> BasicOptimizer<T>::polynomial_terms(
+        const Tree& tree, const std::vector<std::vector<size_t>>& factors, const std::vector<bool>& signs, size_t x) const
+    {
+        std::vector<Term> terms;
+        for (size_t i = 0; i < factors.size(); ++i)
+        {
+            Term term {.negative = signs[i], .degree = 0, .coefficient = {}};
+            for (const size_t factor: factors[i])
+            {
+                if (const std::optional<unsigned> degree = degree_of(tree, factor, x))
+                    term.degree += *degree;
+                else if (tree.uses_argument(factor, x))
+                    return std::nullopt;
+                else
+                    term.coefficient.push_back(factor);
+            }
+            terms.push_back(std::move(term));
+        }
+        return terms;
+    }
+
+    template<typename T>
+    void BasicOptimizer<T>::collect_terms(const Tree& tree, size_t index, bool negative,
+                                          std::vector<size_t>& terms, std::vector<bool>& signs) const
+    {
+        const Node& node = tree.node(index);
+        switch (arithmetic_of(node))
+        {
+            case Arithmetic::Add:
+                collect_terms(tree, node.children[0], negative, terms, signs);
+                collect_terms(tree, node.children[1], negative, terms, signs);
+                break;
+            case Arithmetic::Subtract:
+                collect_terms(tree, node.children[0], negative, terms, signs);
+                collect_terms(tree, node.children[1], !negative, terms, signs);
+                break;
+            default:
+                terms.push_back(index);
+                signs.push_back(negative);
+                break;
+        }
+    }
+
+    template<typename T>
+    void BasicOptimizer<T>::collect_factors(const Tree& tree, size_t index, std::vector<size_t>& factors) const
+    {
+        const Node& node = tree.node(index);
+        if (arithmetic_of(node) == Arithmetic::Multiply)
+        {
+            collect_factors(tree, node.children[0], factors);
+            collect_factors(tree, node.children[1], factors);
+        }
+        else
+            factors.push_back(index);
+    }
+
+    template<typename T>
+    std::optional<unsigned> BasicOptimizer<T>::degree_of(const Tree& tree, size_t factor, size_t arg_index) const
+    {
+        const std::optional<size_t> argument = argument_of(tree, factor);
+        if (!argument || *argument != arg_index)
+            return std::nullopt;
+        const Node& node = tree.node(factor);
+        if (node.unit.type == TokenType::Argument)
+            return 1;
+        return static_cast<unsigned>(*integer_exponent(tree.node(node.children[1])));
+    }
+
+    template<typename T>
+    std::optional<size_t> BasicOptimizer<T>::argument_of(const Tree& tree, size_t factor) const
+    {
+        const Node& node = tree.node(factor);
+        if (node.unit.type == TokenType::Argument)
+            return node.unit.arg_index;
+        if (arithmetic_of(node) != Arithmetic::Power)
+            return std::nullopt;
+        const Node& base = tree.node(node.children[0]);
+        const std::optional<int> exponent = integer_exponent(tree.node(node.children[1]));
+        if (base.unit.type != TokenType::Argument || !exponent || *exponent < 0)
+            return std::nullopt;
+        return base.unit.arg_index;
+    }
+
+    template<typename T>
+    size_t BasicOptimizer<T>::build_coefficient(Tree& tree, const std::vector<const Term*>& terms) const
+    {
+        std::optional<size_t> sum;
+        for (const Term* term: terms)
+        {
+            size_t product = term->coefficient.empty()
+                ? tree.add({.unit = {.type = TokenType::Number, .number = T(1)}})
+                : term->coefficient[0];
+            for (size_t i = 1; i < term->coefficient.size(); ++i)
+                product = binary(tree, m_multiply, product, term->coefficient[i]);
+
+            if (sum)
+                sum = binary(tree, term->negative ? m_subtract : m_add, *sum, product);
+            else if (term->negative)
+                sum = binary(tree, m_subtract, tree.add({.unit = {.type = TokenType::Number, .number = T(0)}}), product);
+            else
+                sum = product;
+        }
+        return *sum;
+    }
+
+    template<typename T>
+    std::optional<int> BasicOptimizer<T>::integer_exponent(const Node& node)
+    {
+        if (node.unit.type != TokenType::Number)
+            return std::nullopt;
+        const T exponent = node.unit.number;
+        if (exponent != std::trunc(exponent) || std::abs(exponent) > T(MaxExponent))
+            return std::nullopt;
+        return static_cast<int>(exponent);
+    }
+
+    template<typename T>
+    Arithmetic BasicOptimizer<T>::arithmetic_of(const Node& node) const
+    {
+        if (node.unit.type != TokenType::Binary)
+            return Arithmetic::None;
+        return m_grammar.arithmetic_of(node.unit.binary);
+    }
+
+    template<typename T>
+    size_t BasicOptimizer<T>::binary(Tree& tree, typename Grammar::Binary op, size_t a, size_t b)
+    {
+        Node node {.unit = {.type = TokenType::Binary, .binary = op}};
+        node.children[0] = a;
+        node.children[1] = b;
+        return tree.add(node);
+    }
+
+    template class BasicOptimizer<float>;
+    template class BasicOptimizer<double>;
+    template class BasicOptimizer<long double>;
+
+} // namespace polishd
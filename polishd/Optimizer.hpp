@@ -0,0 +1,80 @@
+#ifndef INC_POLISHD_OPTIMIZER_HPP
+#define INC_POLISHD_OPTIMIZER_HPP
+
+#include <optional>
+#include <vector>
+
+#include <Grammar.hpp>
+#include <Function.hpp>
+#include <ExpressionTree.hpp>
+
+namespace polishd {
+
+    // Rewrites the compiled units using the operators marked as standard arithmetic by the `Grammar`:
+    // * `x ^ n` with a small integer `n` into a multiplication chain (`Power` unit);
+    // * polynomials in a single argument into Horner's scheme;
+    // * `a * b + c` into a fused multiply-add (`MultiplyAdd` unit).
+    // The rewrites may change the rounding of the results, see `CompileOptions::strict_ieee`.
+    template<typename T>
+    class BasicOptimizer
+    {
+    public:
+        using Grammar = BasicGrammar<T>;
+        using Function = BasicFunction<T>;
+        using Expression = typename Function::Expression;
+
+        explicit BasicOptimizer(const Grammar& grammar);
+
+        void optimize(Expression& expression) const;
+
+    private:
+        using Tree = BasicExpressionTree<T>;
+        using Node = typename Tree::Node;
+
+        // A polynomial term `coefficient * x ^ degree`
+        struct Term
+        {
+            bool negative;
+            unsigned degree;
+            // Factors of the coefficient, an empty one is `1`
+            std::vector<size_t> coefficient;
+        };
+
+        // Largest integer exponent rewritten into multiplications
+        static constexpr int MaxExponent = 64;
+
+        [[nodiscard]] bool has_arithmetic(const Expression& expression) const;
+
+        void rewrite_polynomials(Tree& tree, size_t index) const;
+        void rewrite_operations(Tree& tree, size_t index) const;
+        std::optional<size_t> rewrite_horner(Tree& tree, size_t index) const;
+
+        // The terms of a polynomial in the argument `x` with the `factors` of each term,
+        // or nothing if `x` is also used elsewhere than in a place of `x` or `x ^ n`
+        std::optional<std::vector<Term>> polynomial_terms(const Tree& tree, const std::vector<std::vector<size_t>>& factors,
+                                                          const std::vector<bool>& signs, size_t x) const;
+        void collect_terms(const Tree& tree, size_t index, bool negative, std::vector<size_t>& terms, std::vector<bool>& signs) const;
+        void collect_factors(const Tree& tree, size_t index, std::vector<size_t>& factors) const;
+        // Degree of `x` in the factor, if it is `x` or `x ^ n`
+        std::optional<unsigned> degree_of(const Tree& tree, size_t factor, size_t arg_index) const;
+        std::optional<size_t> argument_of(const Tree& tree, size_t factor) const;
+        size_t build_coefficient(Tree& tree, const std::vector<const Term*>& terms) const;
+
+        static std::optional<int> integer_exponent(const Node& node);
+        Arithmetic arithmetic_of(const Node& node) const;
+        static size_t binary(Tree& tree, typename Grammar::Binary op, size_t a, size_t b);
+
+    private:
+        const Grammar& m_grammar;
+        typename Grammar::Binary m_add;
+        typename Grammar::Binary m_subtract;
+        typename Grammar::Binary m_multiply;
+    };
+
+    extern template class BasicOptimizer<float>;
+    extern template class BasicOptimizer<double>;
+    extern template class BasicOptimizer<long double>;
+
+} // namespace polishd
+
+#endif // INC_POLISHD_OPTIMIZER_HPP
@@ -0,0 +1,43 @@
+#ifndef INC_POLISHD_REDUCTION_HPP
+#define INC_POLISHD_REDUCTION_HPP
+
+#include <cstddef>
+
+namespace polishd {
+
+    // What `BasicFunction::reduce` folds the results of the rows into
+    template<typename T>
+    struct BasicReduction
+    {
+        enum class Kind
+        {
+            // Compensated (Neumaier) sum, 0 for no rows,
+            // +-infinity if a result is +-infinity and NaN if a result is NaN or both infinities occur
+            Sum,
+            // NaN results are skipped, +-infinity for no rows
+            Min,
+            Max,
+            // Compensated sum divided by the number of rows, NaN for no rows
+            Mean,
+            // Number of results greater than `threshold`
+            CountAbove
+        };
+
+        Kind kind = Kind::Sum;
+        T threshold = T(0);
+        // Upper bound of the threads evaluating the rows, 0 for `std::thread::hardware_concurrency()`.
+        // Fewer threads are used for small inputs, so that each gets enough rows to pay off.
+        size_t max_threads = 0;
+
+        static constexpr BasicReduction sum() { return {.kind = Kind::Sum}; }
+        static constexpr BasicReduction min() { return {.kind = Kind::Min}; }
+        static constexpr BasicReduction max() { return {.kind = Kind::Max}; }
+        static constexpr BasicReduction mean() { return {.kind = Kind::Mean}; }
+        static constexpr BasicReduction count_above(T threshold) { return {.kind = Kind::CountAbove, .threshold = threshold}; }
+    };
+
+    using Reduction = BasicReduction<double>;
+
+} // namespace polishd
+
+#endif // INC_POLISHD_REDUCTION_HPP
@@ -0,0 +1,106 @@
+#include <Registry.hpp>
+
+#include <array>
+#include <vector>
+
+#include <compile.hpp>
+#include <exceptions.hpp>
+
+namespace polishd {
+
+    template<typename T>
+    BasicRegistry<T>::Entry::Entry(const Native& native) : m_native(&native)
+    {
+    }
+
+    template<typename T>
+    BasicRegistry<T>::Entry::Entry(Function function) : m_function(std::move(function))
+    {
+    }
+
+    template<typename T>
+    T BasicRegistry<T>::Entry::evaluate(const Args& args) const
+    {
+        if (m_function)
+            return m_function->evaluate(args);
+
+        const auto evaluate_native = [&](T* arg_values)
+        {
+            for (size_t i = 0; i < m_native->arguments.size(); ++i)
+            {
+                const auto lookup = args.find(m_native->arguments[i]);
+                if (lookup == args.end())
+                    throw MissingArgumentError(std::string(m_native->arguments[i]));
+                arg_values[i] = lookup->second;
+            }
+            return m_native->evaluate(arg_values);
+        };
+        // the values are on the stack unless there are too many of them
+        if (m_native->arguments.size() <= MaxStackArguments)
+        {
+            std::array<T, MaxStackArguments> arg_values;
+            return evaluate_native(arg_values.data());
+        }
+        std::vector<T> arg_values(m_native->arguments.size());
+        return evaluate_native(arg_values.data());
+    }
+
+    template<typename T>
+    T BasicRegistry<T>::Entry::operator()(const Args& args) const
+    {
+        return evaluate(args);
+    }
+
+    template<typename T>
+    std::string_view BasicRegistry<T>::Entry::infix() const
+    {
+        return m_function ? std::string_view(m_function->infix()) : m_native->infix;
+    }
+
+    template<typename T>
+    auto BasicRegistry<T>::Entry::native() const -> typename Native::Evaluate
+    {
+        return m_native ? m_native->evaluate : nullptr;
+    }
+
+    template<typename T>
+    auto BasicRegistry<T>::Entry::function() const -> const Function*
+    {
+        return m_function ? &*m_function : nullptr;
+    }
+
+    template<typename T>
+    BasicRegistry<T>::BasicRegistry(const Grammar& grammar, const CompileOptions& options)
+        : m_grammar(grammar), m_options(options)
+    {
+    }
+
+    template<typename T>
+    void BasicRegistry<T>::add(std::span<const Native> natives)
+    {
+        for (const Native& native: natives)
+            m_entries.insert_or_assign(std::string(native.name), Entry(native));
+    }
+
+    template<typename T>
+    auto BasicRegistry<T>::get(std::string_view name, const std::string& infix) -> const Entry&
+    {
+        const auto lookup = m_entries.find(name);
+        if (lookup != m_entries.end() && lookup->second.infix() == infix)
+            return lookup->second;
+        // either unknown or generated from an outdated expression
+        return m_entries.insert_or_assign(std::string(name), Entry(compile(m_grammar, infix, m_options))).first->second;
+    }
+
+    template<typename T>
+    auto BasicRegistry<T>::find(std::string_view name) const -> const Entry*
+    {
+        const auto lookup = m_entries.find(name);
+        return lookup != m_entries.end() ? &lookup->second : nullptr;
+    }
+
+    template class BasicRegistry<float>;
+    template class BasicRegistry<double>;
+    template class BasicRegistry<long double>;
+
+} // namespace polishd
@@ -0,0 +1,81 @@
+#ifndef INC_POLISHD_REGISTRY_HPP
+#define INC_POLISHD_REGISTRY_HPP
+
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+#include <TransparentStringKeyMap.hpp>
+#include <Grammar.hpp>
+#include <Function.hpp>
+#include <NativeFunction.hpp>
+#include <CompileOptions.hpp>
+
+namespace polishd {
+
+    // Named expressions, evaluated by the code generated ahead of time when there is one
+    // and compiled at runtime otherwise.
+    // Not thread-safe: `get` may compile and store a function.
+    template<typename T>
+    class BasicRegistry
+    {
+    public:
+        using Grammar = BasicGrammar<T>;
+        using Function = BasicFunction<T>;
+        using Native = BasicNativeFunction<T>;
+        using Args = BasicArgs<T>;
+
+        class Entry
+        {
+        public:
+            explicit Entry(const Native& native);
+            explicit Entry(Function function);
+
+            [[nodiscard]] T evaluate(const Args& args) const;
+            T operator()(const Args& args) const;
+
+            [[nodiscard]] std::string_view infix() const;
+            // The generated code, or `nullptr` if the expression was compiled at runtime
+            [[nodiscard]] typename Native::Evaluate native() const;
+            // The compiled function, or `nullptr` if the expression has generated code
+            [[nodiscard]] const Function* function() const;
+
+        private:
+            // Most arguments a native function is evaluated with without allocating
+            static constexpr size_t MaxStackArguments = 64;
+
+            const Native* m_native = nullptr;
+            std::optional<Function> m_function;
+        };
+
+        explicit BasicRegistry(const Grammar& grammar, const CompileOptions& options = {});
+
+        // Registers generated functions, e.g. the `functions` table of a generated header.
+        // The table must outlive the registry.
+        void add(std::span<const Native> natives);
+
+        // The expression registered as `name` if it has the same `infix`,
+        // otherwise `infix` compiled and registered as `name`.
+        // Throws the same exceptions as `compile`.
+        const Entry& get(std::string_view name, const std::string& infix);
+
+        // The expression registered as `name`, if any
+        [[nodiscard]] const Entry* find(std::string_view name) const;
+
+    private:
+        const Grammar& m_grammar;
+        CompileOptions m_options;
+        TransparentStringKeyMap<Entry> m_entries;
+    };
+
+    extern template class BasicRegistry<float>;
+    extern template class BasicRegistry<double>;
+    extern template class BasicRegistry<long double>;
+
+    using Registry = BasicRegistry<double>;
+
+} // namespace polishd
+
+#endif // INC_POLISHD_REGISTRY_HPP
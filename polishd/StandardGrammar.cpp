@@ -0,0 +1,45 @@
+#include <StandardGrammar.hpp>
+
+#include <numbers>
+
+#include <Kernels.hpp>
+
+namespace polishd {
+
+    template<typename T>
+    BasicGrammar<T> standard_grammar()
+    {
+        BasicGrammar<T> grammar;
+
+        grammar.add_constant("pi", std::numbers::pi_v<T>);
+        grammar.add_constant("e", std::numbers::e_v<T>);
+
+        grammar.add_prefix_operator("-", kernels::negate<T>);
+        grammar.add_prefix_operator("exp", kernels::exp<T>);
+        grammar.add_prefix_operator("log", kernels::log<T>);
+        grammar.add_prefix_operator("sin", kernels::sin<T>);
+        grammar.add_prefix_operator("cos", kernels::cos<T>);
+        grammar.add_prefix_operator("sqrt", kernels::sqrt<T>);
+        grammar.add_prefix_operator("floor", kernels::floor<T>);
+        grammar.add_prefix_operator("ceil", kernels::ceil<T>);
+        grammar.add_prefix_operator("round", kernels::round<T>);
+        grammar.add_prefix_operator("abs", kernels::abs<T>);
+
+        grammar.add_binary_operator("<", kernels::less<T>, 0);
+        grammar.add_binary_operator(">", kernels::greater<T>, 0);
+        grammar.add_binary_operator("<=", kernels::less_equal<T>, 0);
+        grammar.add_binary_operator(">=", kernels::greater_equal<T>, 0);
+        grammar.add_binary_operator("+", kernels::add<T>, 1, Arithmetic::Add);
+        grammar.add_binary_operator("-", kernels::subtract<T>, 1, Arithmetic::Subtract);
+        grammar.add_binary_operator("*", kernels::multiply<T>, 2, Arithmetic::Multiply);
+        grammar.add_binary_operator("/", kernels::divide<T>, 2, Arithmetic::Divide);
+        grammar.add_binary_operator("^", kernels::pow<T>, 3, Arithmetic::Power);
+
+        return grammar;
+    }
+
+    template BasicGrammar<float> standard_grammar<float>();
+    template BasicGrammar<double> standard_grammar<double>();
+    template BasicGrammar<long double> standard_grammar<long double>();
+
+} // namespace polishd
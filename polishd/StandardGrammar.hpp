@@ -0,0 +1,22 @@
+#ifndef INC_POLISHD_STANDARD_GRAMMAR_HPP
+#define INC_POLISHD_STANDARD_GRAMMAR_HPP
+
+#include <Grammar.hpp>
+
+namespace polishd {
+
+    // A grammar with the constants `pi` and `e`,
+    // the prefix operators `-`, `exp`, `log`, `sin`, `cos`, `sqrt`, `floor`, `ceil`, `round` and `abs`,
+    // the comparisons `<`, `>`, `<=` and `>=` giving 1 or 0 with the precedence 0,
+    // and the arithmetic operators `+`, `-` with the precedence 1, `*`, `/` with 2 and `^` with 3.
+    // The operators are the ones of `kernels`, so the batch evaluation runs their vectorized kernels.
+    template<typename T = double>
+    [[nodiscard]] BasicGrammar<T> standard_grammar();
+
+    extern template BasicGrammar<float> standard_grammar<float>();
+    extern template BasicGrammar<double> standard_grammar<double>();
+    extern template BasicGrammar<long double> standard_grammar<long double>();
+
+} // namespace polishd
+
+#endif // INC_POLISHD_STANDARD_GRAMMAR_HPP
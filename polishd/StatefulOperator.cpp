@@ -0,0 +1,313 @@
+#include <StatefulOperator.hpp>
+
+#include <cmath>
+#include <limits>
+#include <new>
+#include <stdexcept>
+
+namespace polishd {
+
+    namespace {
+
+        // The last `window` samples
+        template<typename T>
+        struct Window
+        {
+            size_t count;
+            size_t next;
+            // Sum of the finite samples, recomputed from the samples every `window` steps,
+            // so that the rounding errors of the running sum do not build up over long streams
+            T sum;
+            size_t steps;
+            // The non-finite samples are counted instead of summed, so that the sum recovers once they leave
+            size_t nans;
+            size_t positive_infinities;
+            size_t negative_infinities;
+
+            T* samples()
+            {
+                return reinterpret_cast<T*>(this + 1);
+            }
+
+            // Returns the sample that left the window, if the window was full
+            bool push(size_t window, T sample, T& evicted)
+            {
+                const bool full = count == window;
+                evicted = samples()[next];
+                samples()[next] = sample;
+                next = next + 1 == window ? 0 : next + 1;
+                count += !full;
+                return full;
+            }
+
+            void add(T sample)
+            {
+                if (std::isfinite(sample))
+                    sum += sample;
+                else
+                    non_finite(sample) += 1;
+            }
+
+            void remove(T sample)
+            {
+                if (std::isfinite(sample))
+                    sum -= sample;
+                else
+                    non_finite(sample) -= 1;
+            }
+
+            size_t& non_finite(T sample)
+            {
+                if (std::isnan(sample))
+                    return nans;
+                return sample > T(0) ? positive_infinities : negative_infinities;
+            }
+
+            void resum()
+            {
+                sum = T(0);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    if (std::isfinite(samples()[i]))
+                        sum += samples()[i];
+                }
+            }
+
+            // The sum of all samples, as if they were added one by one
+            [[nodiscard]] T total() const
+            {
+                if (nans || (positive_infinities && negative_infinities))
+                    return std::numeric_limits<T>::quiet_NaN();
+                if (positive_infinities)
+                    return std::numeric_limits<T>::infinity();
+                if (negative_infinities)
+                    return -std::numeric_limits<T>::infinity();
+                return sum;
+            }
+        };
+
+        template<typename T>
+        void init_window(std::byte* state, const BasicStatefulOperator<T>&)
+        {
+            new (state) Window<T> {};
+        }
+
+        template<typename T>
+        T step_sum(std::byte* state, const BasicStatefulOperator<T>& op, T sample)
+        {
+            auto& window = *reinterpret_cast<Window<T>*>(state);
+            T evicted;
+            if (window.push(op.window, sample, evicted))
+                window.remove(evicted);
+            window.add(sample);
+            if (++window.steps == op.window)
+            {
+                window.steps = 0;
+                window.resum();
+            }
+            return window.total();
+        }
+
+        template<typename T>
+        T step_average(std::byte* state, const BasicStatefulOperator<T>& op, T sample)
+        {
+            const T sum = step_sum(state, op, sample);
+            return sum / static_cast<T>(reinterpret_cast<Window<T>*>(state)->count);
+        }
+
+        template<typename T>
+        struct Extreme
+        {
+            size_t index;
+            T value;
+        };
+
+        // A monotonic queue of the samples that may still become the extreme,
+        // so each sample is pushed and popped at most once.
+        // The NaN samples are kept out of it, as they compare neither before nor after the others.
+        template<typename T>
+        struct alignas(Extreme<T>) Extremes
+        {
+            // Position of the next sample
+            size_t index;
+            // Position of the first sample whose window no longer holds the last NaN sample
+            size_t nan_end;
+            // A ring buffer of `window` entries, `size` of them starting from `head`
+            size_t head;
+            size_t size;
+
+            Extreme<T>* entries()
+            {
+                return reinterpret_cast<Extreme<T>*>(this + 1);
+            }
+        };
+
+        template<typename T>
+        void init_extremes(std::byte* state, const BasicStatefulOperator<T>&)
+        {
+            new (state) Extremes<T> {.index = 0, .nan_end = 0, .head = 0, .size = 0};
+        }
+
+        template<typename T, typename Before>
+        T step_extremes(std::byte* state, const BasicStatefulOperator<T>& op, T sample)
+        {
+            auto& extremes = *reinterpret_cast<Extremes<T>*>(state);
+            auto* const entries = extremes.entries();
+            const auto at = [&](size_t i) -> auto& { return entries[(extremes.head + i) % op.window]; };
+
+            // the oldest entry leaves the window
+            if (extremes.size && at(0).index + op.window <= extremes.index)
+            {
+                extremes.head = (extremes.head + 1) % op.window;
+                --extremes.size;
+            }
+            const size_t index = extremes.index++;
+            if (std::isnan(sample))
+            {
+                extremes.nan_end = index + op.window;
+                return sample;
+            }
+            // the entries that can no longer be the extreme
+            while (extremes.size && !Before()(at(extremes.size - 1).value, sample))
+                --extremes.size;
+            at(extremes.size++) = {index, sample};
+            return index < extremes.nan_end ? std::numeric_limits<T>::quiet_NaN() : at(0).value;
+        }
+
+        template<typename T>
+        struct Less
+        {
+            bool operator()(T a, T b) const
+            {
+                return a < b;
+            }
+        };
+
+        template<typename T>
+        struct Greater
+        {
+            bool operator()(T a, T b) const
+            {
+                return a > b;
+            }
+        };
+
+        template<typename T>
+        void init_previous(std::byte* state, const BasicStatefulOperator<T>&)
+        {
+            new (state) T(std::numeric_limits<T>::quiet_NaN());
+        }
+
+        template<typename T>
+        T step_previous(std::byte* state, const BasicStatefulOperator<T>&, T sample)
+        {
+            T& previous = *reinterpret_cast<T*>(state);
+            const T result = previous;
+            previous = sample;
+            return result;
+        }
+
+        template<typename T>
+        struct Smoothing
+        {
+            bool started;
+            T value;
+        };
+
+        template<typename T>
+        void init_smoothing(std::byte* state, const BasicStatefulOperator<T>&)
+        {
+            new (state) Smoothing<T> {.started = false, .value = T(0)};
+        }
+
+        template<typename T>
+        T step_smoothing(std::byte* state, const BasicStatefulOperator<T>& op, T sample)
+        {
+            auto& smoothing = *reinterpret_cast<Smoothing<T>*>(state);
+            smoothing.value = smoothing.started ? op.factor * sample + (T(1) - op.factor) * smoothing.value : sample;
+            smoothing.started = true;
+            return smoothing.value;
+        }
+
+        void check_window(size_t window)
+        {
+            if (window == 0)
+                throw std::invalid_argument("the window of a stateful operator must not be empty");
+        }
+
+    }
+
+    template<typename T>
+    BasicStatefulOperator<T> BasicStatefulOperator<T>::moving_average(size_t window)
+    {
+        check_window(window);
+        return {
+            .init = init_window<T>,
+            .step = step_average<T>,
+            .state_size = sizeof(Window<T>) + window * sizeof(T),
+            .window = window
+        };
+    }
+
+    template<typename T>
+    BasicStatefulOperator<T> BasicStatefulOperator<T>::moving_sum(size_t window)
+    {
+        check_window(window);
+        return {
+            .init = init_window<T>,
+            .step = step_sum<T>,
+            .state_size = sizeof(Window<T>) + window * sizeof(T),
+            .window = window
+        };
+    }
+
+    template<typename T>
+    BasicStatefulOperator<T> BasicStatefulOperator<T>::moving_min(size_t window)
+    {
+        check_window(window);
+        return {
+            .init = init_extremes<T>,
+            .step = step_extremes<T, Less<T>>,
+            .state_size = sizeof(Extremes<T>) + window * sizeof(Extreme<T>),
+            .window = window
+        };
+    }
+
+    template<typename T>
+    BasicStatefulOperator<T> BasicStatefulOperator<T>::moving_max(size_t window)
+    {
+        check_window(window);
+        return {
+            .init = init_extremes<T>,
+            .step = step_extremes<T, Greater<T>>,
+            .state_size = sizeof(Extremes<T>) + window * sizeof(Extreme<T>),
+            .window = window
+        };
+    }
+
+    template<typename T>
+    BasicStatefulOperator<T> BasicStatefulOperator<T>::previous()
+    {
+        return {
+            .init = init_previous<T>,
+            .step = step_previous<T>,
+            .state_size = sizeof(T)
+        };
+    }
+
+    template<typename T>
+    BasicStatefulOperator<T> BasicStatefulOperator<T>::exponential_smoothing(T factor)
+    {
+        return {
+            .init = init_smoothing<T>,
+            .step = step_smoothing<T>,
+            .state_size = sizeof(Smoothing<T>),
+            .factor = factor
+        };
+    }
+
+    template struct BasicStatefulOperator<float>;
+    template struct BasicStatefulOperator<double>;
+    template struct BasicStatefulOperator<long double>;
+
+} // namespace polishd
@@ -0,0 +1,45 @@
+#ifndef INC_POLISHD_STATEFUL_OPERATOR_HPP
+#define INC_POLISHD_STATEFUL_OPERATOR_HPP
+
+#include <cstddef>
+
+namespace polishd {
+
+    // A prefix operator that remembers the previous samples of its operand,
+    // e.g. a moving average. It is only evaluated by a `BasicStreamEvaluator`,
+    // which keeps a separate state of `state_size` bytes for each occurrence of the operator.
+    // Neither `init` nor `step` may allocate, the state is all the memory they get.
+    template<typename T>
+    struct BasicStatefulOperator
+    {
+        // Fills the initial state, the state is zeroed if it is `nullptr`
+        void (*init)(std::byte* state, const BasicStatefulOperator& op) = nullptr;
+        // Consumes the next sample of the operand and returns the value of the operator
+        T (*step)(std::byte* state, const BasicStatefulOperator& op, T sample) = nullptr;
+        size_t state_size = 0;
+        // Parameters of the operator
+        size_t window = 0;
+        T factor = T(0);
+
+        // The mean of the last `window` samples, or of all of them until there are `window`
+        static BasicStatefulOperator moving_average(size_t window);
+        // A NaN or an infinite sample only affects the results while it is in the window of the sum or the mean
+        static BasicStatefulOperator moving_sum(size_t window);
+        // Extremes of the last `window` samples, NaN while a NaN sample is in the window like for the sum
+        static BasicStatefulOperator moving_min(size_t window);
+        static BasicStatefulOperator moving_max(size_t window);
+        // The sample before the current one, NaN for the first sample
+        static BasicStatefulOperator previous();
+        // `s = factor * sample + (1 - factor) * s`, starting from the first sample
+        static BasicStatefulOperator exponential_smoothing(T factor);
+    };
+
+    extern template struct BasicStatefulOperator<float>;
+    extern template struct BasicStatefulOperator<double>;
+    extern template struct BasicStatefulOperator<long double>;
+
+    using StatefulOperator = BasicStatefulOperator<double>;
+
+} // namespace polishd
+
+#endif // INC_POLISHD_STATEFUL_OPERATOR_HPP
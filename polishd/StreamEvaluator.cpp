@@ -0,0 +1,99 @@
+#include <StreamEvaluator.hpp>
+
+namespace polishd {
+
+    template<typename T>
+    BasicStreamEvaluator<T>::BasicStreamEvaluator(const Function& f)
+        : m_function(&f),
+          m_workspace(f.make_workspace()),
+          m_arg_values(f.arguments().size()),
+          m_value_columns(f.arguments().size()),
+          m_arg_columns(f.arguments().size())
+    {
+        for (size_t i = 0; i < m_arg_values.size(); ++i)
+            m_value_columns[i] = &m_arg_values[i];
+    }
+
+    template<typename T>
+    T BasicStreamEvaluator<T>::push(const Args& args)
+    {
+        const Expected<T> result = try_push(args);
+        if (!result)
+            result.error().raise(m_function->infix());
+        return *result;
+    }
+
+    template<typename T>
+    void BasicStreamEvaluator<T>::push(const Columns& columns, T* out, size_t count)
+    {
+        const Expected<void> result = try_push(columns, out, count);
+        if (!result)
+            result.error().raise(m_function->infix());
+    }
+
+    template<typename T>
+    Expected<T> BasicStreamEvaluator<T>::try_push(const Args& args)
+    {
+        const std::vector<std::string_view>& arg_names = m_function->arguments();
+        for (size_t i = 0; i < arg_names.size(); ++i)
+        {
+            const auto lookup = args.find(arg_names[i]);
+            if (lookup == args.end())
+                return m_function->missing_argument(arg_names[i]);
+            m_arg_values[i] = lookup->second;
+        }
+        T result;
+#ifdef POLISHD_INSTRUMENTATION
+        if (instrumentation::enabled() && m_function->m_counters.count(1)) [[unlikely]]
+        {
+            instrumentation::UnitProfile profile;
+            m_function->run_stream(m_value_columns, &result, 1, m_workspace, &profile);
+            m_function->m_counters.record(profile);
+            return result;
+        }
+#endif
+        m_function->run_stream(m_value_columns, &result, 1, m_workspace, nullptr);
+        return result;
+    }
+
+    template<typename T>
+    Expected<void> BasicStreamEvaluator<T>::try_push(const Columns& columns, T* out, size_t count)
+    {
+        const std::vector<std::string_view>& arg_names = m_function->arguments();
+        for (size_t i = 0; i < arg_names.size(); ++i)
+        {
+            const auto lookup = columns.find(arg_names[i]);
+            if (lookup == columns.end())
+                return m_function->missing_argument(arg_names[i]);
+            m_arg_columns[i] = lookup->second;
+        }
+#ifdef POLISHD_INSTRUMENTATION
+        if (instrumentation::enabled() && m_function->m_counters.count(count)) [[unlikely]]
+        {
+            instrumentation::UnitProfile profile;
+            m_function->run_stream(m_arg_columns, out, count, m_workspace, &profile);
+            m_function->m_counters.record(profile);
+            return {};
+        }
+#endif
+        m_function->run_stream(m_arg_columns, out, count, m_workspace, nullptr);
+        return {};
+    }
+
+    template<typename T>
+    void BasicStreamEvaluator<T>::reset()
+    {
+        m_function->init_state(m_workspace.state.data());
+    }
+
+    template<typename T>
+    auto BasicStreamEvaluator<T>::function() const -> const Function&
+    {
+        return *m_function;
+    }
+
+    template class BasicStreamEvaluator<float>;
+    template class BasicStreamEvaluator<double>;
+    template class BasicStreamEvaluator<long double>;
+
+} // namespace polishd
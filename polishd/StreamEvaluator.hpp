@@ -0,0 +1,58 @@
+#ifndef INC_POLISHD_STREAM_EVALUATOR_HPP
+#define INC_POLISHD_STREAM_EVALUATOR_HPP
+
+#include <vector>
+
+#include <Function.hpp>
+#include <Expected.hpp>
+
+namespace polishd {
+
+    // Evaluates a function over a stream of samples, one at a time or in chunks,
+    // keeping the state of its stateful operators between the samples.
+    // The buffers are allocated once, so feeding the samples allocates nothing.
+    // Stateful operators see every sample, including in the branch of a selection that is not selected.
+    template<typename T>
+    class BasicStreamEvaluator
+    {
+    public:
+        using Function = BasicFunction<T>;
+        using Args = BasicArgs<T>;
+        using Columns = BasicColumns<T>;
+
+        // `f` must outlive the evaluator
+        explicit BasicStreamEvaluator(const Function& f);
+
+        // Feeds a single sample and returns the value of the function for it
+        T push(const Args& args);
+        // Feeds `count` samples, the i-th made of the i-th values of the columns,
+        // and writes the values of the function to `out`
+        void push(const Columns& columns, T* out, size_t count);
+
+        // Non-throwing variants of `push`, a failed push feeds nothing
+        [[nodiscard]] Expected<T> try_push(const Args& args);
+        [[nodiscard]] Expected<void> try_push(const Columns& columns, T* out, size_t count);
+
+        // Forgets all the samples fed so far
+        void reset();
+
+        [[nodiscard]] const Function& function() const;
+
+    private:
+        const Function* m_function;
+        typename Function::Workspace m_workspace;
+        // The arguments of a single sample, and the columns of a single row pointing to them
+        std::vector<T> m_arg_values;
+        std::vector<const T*> m_value_columns;
+        std::vector<const T*> m_arg_columns;
+    };
+
+    extern template class BasicStreamEvaluator<float>;
+    extern template class BasicStreamEvaluator<double>;
+    extern template class BasicStreamEvaluator<long double>;
+
+    using StreamEvaluator = BasicStreamEvaluator<double>;
+
+} // namespace polishd
+
+#endif // INC_POLISHD_STREAM_EVALUATOR_HPP
@@ -0,0 +1,32 @@
+#ifndef INC_POLISHD_SWEEP_HPP
+#define INC_POLISHD_SWEEP_HPP
+
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstddef>
+
+namespace polishd {
+
+    // The values an argument takes in `BasicFunction::sweep`, either listed or spread over a range
+    template<typename T>
+    struct BasicSweepAxis
+    {
+        std::string name;
+        std::vector<T> values;
+
+        // `count` evenly spaced values from `first` to `last`, both included
+        static BasicSweepAxis range(std::string name, T first, T last, size_t count)
+        {
+            BasicSweepAxis axis {.name = std::move(name), .values = std::vector<T>(count)};
+            for (size_t i = 0; i < count; ++i)
+                axis.values[i] = count == 1 ? first : std::lerp(first, last, static_cast<T>(i) / static_cast<T>(count - 1));
+            return axis;
+        }
+    };
+
+    using SweepAxis = BasicSweepAxis<double>;
+
+} // namespace polishd
+
+#endif // INC_POLISHD_SWEEP_HPP
@@ -1,6 +1,7 @@
 #ifndef INC_POLISHD_TOKEN_HPP
 #define INC_POLISHD_TOKEN_HPP
 
+#include <cstddef>
 #include <string_view>
 
 namespace polishd {
@@ -14,9 +15,27 @@ namespace polishd {
         Postfix,
         Opening,
         Closing,
-        Argument
+        Argument,
+        // `?` of the `condition ? consequent : alternative` selection
+        Condition,
+        // `:` of the selection
+        Alternative,
+        // The end of the selection, produced by the conversion to postfix
+        Select,
+        // Units produced by the optimizer:
+        // raising to a small integer power by repeated multiplication
+        Power,
+        // `a * b + c` with a single rounding
+        MultiplyAdd,
+        // A prefix operator with a state, see `BasicStatefulOperator`
+        Stateful,
+        // A prefix operator with a cache of its results, see `BasicMemoizedOperator`
+        Memoized
     };
 
+    // Number of `TokenType` values, for tables indexed by the type
+    constexpr size_t TokenTypeCount = static_cast<size_t>(TokenType::Memoized) + 1;
+
     struct Token
     {
         TokenType type;
@@ -4,9 +4,24 @@
 
 namespace polishd {
 
-    Function compile(const Grammar& grammar, const std::string& infix)
+    template<typename T>
+    BasicFunction<T> compile(const BasicGrammar<T>& grammar, const std::string& infix, const CompileOptions& options)
     {
-        return CompilingContext(grammar, infix).compile();
+        return BasicCompilingContext<T>(grammar, infix, options).compile();
     }
 
+    template<typename T>
+    Expected<BasicFunction<T>> try_compile(const BasicGrammar<T>& grammar, const std::string& infix, const CompileOptions& options)
+    {
+        return BasicCompilingContext<T>(grammar, infix, options).try_compile();
+    }
+
+    template BasicFunction<float> compile(const BasicGrammar<float>&, const std::string&, const CompileOptions&);
+    template BasicFunction<double> compile(const BasicGrammar<double>&, const std::string&, const CompileOptions&);
+    template BasicFunction<long double> compile(const BasicGrammar<long double>&, const std::string&, const CompileOptions&);
+
+    template Expected<BasicFunction<float>> try_compile(const BasicGrammar<float>&, const std::string&, const CompileOptions&);
+    template Expected<BasicFunction<double>> try_compile(const BasicGrammar<double>&, const std::string&, const CompileOptions&);
+    template Expected<BasicFunction<long double>> try_compile(const BasicGrammar<long double>&, const std::string&, const CompileOptions&);
+
 } // namespace polishd
@@ -5,10 +5,26 @@
 
 #include <Grammar.hpp>
 #include <Function.hpp>
+#include <Expected.hpp>
+#include <CompileOptions.hpp>
 
 namespace polishd {
 
-    Function compile(const Grammar& grammar, const std::string& infix);
+    template<typename T>
+    BasicFunction<T> compile(const BasicGrammar<T>& grammar, const std::string& infix, const CompileOptions& options = {});
+
+    // Same as `compile`, but returns an `Error` instead of throwing on invalid syntax.
+    // Use `Error::message(infix)` to get the message of a failure.
+    template<typename T>
+    Expected<BasicFunction<T>> try_compile(const BasicGrammar<T>& grammar, const std::string& infix, const CompileOptions& options = {});
+
+    extern template BasicFunction<float> compile(const BasicGrammar<float>&, const std::string&, const CompileOptions&);
+    extern template BasicFunction<double> compile(const BasicGrammar<double>&, const std::string&, const CompileOptions&);
+    extern template BasicFunction<long double> compile(const BasicGrammar<long double>&, const std::string&, const CompileOptions&);
+
+    extern template Expected<BasicFunction<float>> try_compile(const BasicGrammar<float>&, const std::string&, const CompileOptions&);
+    extern template Expected<BasicFunction<double>> try_compile(const BasicGrammar<double>&, const std::string&, const CompileOptions&);
+    extern template Expected<BasicFunction<long double>> try_compile(const BasicGrammar<long double>&, const std::string&, const CompileOptions&);
 
 }
 
@@ -12,6 +12,13 @@ namespace polishd
 
     ExpressionSyntaxError::ExpressionSyntaxError(const std::string& what) : Exception("Invalid expression syntax: " + what) {}
 
+    StatefulFunctionError::StatefulFunctionError()
+        : Exception("The expression has stateful operators, evaluate it with a StreamEvaluator") {}
+
+    CodeGenerationError::CodeGenerationError(const std::string& what) : Exception("Code generation failed: " + what) {}
+
+    FunctionGraphError::FunctionGraphError(const std::string& what) : Exception("Invalid function graph: " + what) {}
+
     namespace
     {
         
@@ -34,6 +41,20 @@ namespace polishd
                     return "Opening";
                 case TokenType::Closing:
                     return "Closing";
+                case TokenType::Condition:
+                    return "Condition";
+                case TokenType::Alternative:
+                    return "Alternative";
+                case TokenType::Select:
+                    return "Select";
+                case TokenType::Power:
+                    return "Power";
+                case TokenType::MultiplyAdd:
+                    return "MultiplyAdd";
+                case TokenType::Stateful:
+                    return "Stateful";
+                case TokenType::Memoized:
+                    return "Memoized";
             }
         }
 
@@ -26,6 +26,24 @@ namespace polishd {
         explicit ExpressionSyntaxError(const std::string& what);
     };
 
+    class StatefulFunctionError : public Exception
+    {
+    public:
+        StatefulFunctionError();
+    };
+
+    class CodeGenerationError : public Exception
+    {
+    public:
+        explicit CodeGenerationError(const std::string& what);
+    };
+
+    class FunctionGraphError : public Exception
+    {
+    public:
+        explicit FunctionGraphError(const std::string& what);
+    };
+
     class UnexpectedTokenError : public Exception
     {
     public:
@@ -2,8 +2,18 @@
 #define INC_POLISHD_POLISHD_HPP
 
 #include <exceptions.hpp>
+#include <Error.hpp>
+#include <Expected.hpp>
+#include <Instrumentation.hpp>
 #include <Grammar.hpp>
+#include <Kernels.hpp>
+#include <StandardGrammar.hpp>
 #include <Function.hpp>
+#include <CompileOptions.hpp>
 #include <compile.hpp>
+#include <CodeGenerator.hpp>
+#include <Registry.hpp>
+#include <StreamEvaluator.hpp>
+#include <FunctionGraph.hpp>
 
 #endif // INC_POLISHD_POLISHD_HPP